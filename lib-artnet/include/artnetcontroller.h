@@ -105,6 +105,7 @@ private:
 	void HandlePoll();
 	void HandlePollReply();
 	void HandleTrigger();
+	void SendDmxUnicast(const struct TArtNetPollTableUniverses *IpAddresses);
 	void ActiveUniversesAdd(uint16_t nUniverse);
 	void ActiveUniversesClear();
 
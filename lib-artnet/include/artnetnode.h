@@ -36,6 +36,8 @@
 #include "packets.h"
 
 #include "lightset.h"
+#include "lightsetframe.h"
+#include "lightsetmergepool.h"
 #include "ledblink.h"
 
 #include "artnettimecode.h"
@@ -54,6 +56,18 @@ enum TArtNetNodeMaxPorts {
 	ARTNET_NODE_MAX_PORTS_INPUT = ArtNet::MAX_PORTS
 };
 
+enum TArtNetNodeMerge {
+	ARTNET_NODE_MERGE_SOURCES_DEFAULT = 2,					///< Art-Net merges two sources
+	ARTNET_NODE_MAX_MERGE_SOURCES = 4,
+	ARTNET_NODE_MERGE_BUFFERS_DEFAULT = ArtNet::MAX_PORTS * ARTNET_NODE_MERGE_SOURCES_DEFAULT
+};
+
+enum TArtNetNodeDrain {
+	ARTNET_NODE_DRAIN_PACKETS_DEFAULT = 8,		///< Packets handled in one Run
+	ARTNET_NODE_DRAIN_MICROS_DEFAULT = 1000,	///< Time for handling the packets in one Run
+	ARTNET_NODE_QUEUE_DEPTH = 32				///< Datagrams queued between two Run, a full 16 universe frame
+};
+
 
 /**
  * Table 3 – NodeReport Codes
@@ -122,21 +136,32 @@ struct TArtNetNode {
 	uint8_t Status2;
 };
 
+struct TArtNetNodeRunStats {
+	uint32_t nPackets;		///< Packets received
+	uint32_t nBurstMax;		///< Most packets handled in one Run
+	uint32_t nBurstLimited;	///< Run returned at the packet or time limit, more packets may be waiting
+};
+
 struct TGenericPort {
 	uint16_t nPortAddress;		///< One of the 32,768 possible addresses to which a DMX frame can be directed. The Port-Address is a 15 bit number composed of Net+Sub-Net+Universe.
 	uint8_t nDefaultAddress;	///< the address set by the hardware
 	uint8_t nStatus;			///<
 };
 
+struct TArtNetMergeSource {
+	uint8_t *pData;						///< The data received, a pool buffer only while merging
+	uint32_t nIp;						///< The IP address of the source
+	uint32_t nMillis;					///< The latest time of the data received
+	uint16_t nLength;					///< Length of the data received
+};
+
 struct TOutputPort {
 	uint8_t data[ArtNet::DMX_LENGTH];	///< Data sent
 	uint16_t nLength;					///< Length of sent DMX data
-	uint8_t dataA[ArtNet::DMX_LENGTH];	///< The data received from Port A
-	uint32_t nMillisA;					///< The latest time of the data received from Port A
-	uint32_t ipA;						///< The IP address for port A
-	uint8_t dataB[ArtNet::DMX_LENGTH];	///< The data received from Port B
-	uint32_t nMillisB;					///< The latest time of the data received from Port B
-	uint32_t ipB;						///< The IP address for Port B
+	struct TLightSetDirty tDirty;		///< Slots changed since the last LightSet::SetDataRange
+	struct TArtNetMergeSource aSources[ARTNET_NODE_MAX_MERGE_SOURCES];
+	uint8_t nSources;					///< Number of sources, merging when > 1
+	uint8_t nMaxSources;				///< Sources merged, more sources are discarded
 	ArtNetMerge mergeMode;				///< \ref ArtNetMerge
 	bool IsDataPending;					///< ArtDMX received and waiting for ArtSync
 	bool bIsEnabled;					///< Is the port enabled ?
@@ -144,6 +169,18 @@ struct TOutputPort {
 	TPortProtocol tPortProtocol;		///< Art-Net 4
 };
 
+/**
+ * Port-Address to output port lookup, rebuilt whenever the patch changes.
+ * Bits 14-4 (Net + Sub-Net) select a block, bits 3-0 (Universe) select the mask of output ports.
+ */
+struct TPortAddressMap {
+	uint8_t nBlockIndex[1U << 11];								///< 0 = not patched, otherwise block index + 1
+	uint32_t nPortMask[ArtNet::MAX_PAGES][1U << 4];				///< Bit n set = output port n is patched
+};
+
+static_assert(ARTNET_NODE_MAX_PORTS_OUTPUT <= 32, "nPortMask is too small");
+static_assert(ARTNET_NODE_MAX_PORTS_OUTPUT <= LightSetFrame::MAX_PORTS, "LightSetFrame port mask is too small");
+
 struct TInputPort {
 	bool bIsEnabled;
 	TGenericPort port;
@@ -160,6 +197,11 @@ public:
 	void Stop();
 
 	void Run();
+	/**
+	 * Milliseconds until Run() has timed work to do, UINT32_MAX when it only reacts on received packets.
+	 * For an event-driven main loop, waiting for a readable handle.
+	 */
+	uint32_t GetTimeoutMillis();
 
 	uint8_t GetVersion() {
 		return m_nVersion;
@@ -171,11 +213,23 @@ public:
 
 	void SetOutput(LightSet *pLightSet) {
 		m_pLightSet = pLightSet;
+		m_LightSetFrame.SetLightSet(pLightSet);
 	}
 	LightSet *GetOutput() const {
 		return m_pLightSet;
 	}
 
+	/**
+	 * Maximum time between the first and the last universe of a frame,
+	 * the frame is committed to the output when it expires.
+	 */
+	void SetFrameDeadline(uint32_t nDeadlineMillis) {
+		m_LightSetFrame.SetDeadline(nDeadlineMillis);
+	}
+	uint32_t GetFrameDeadline() const {
+		return m_LightSetFrame.GetDeadline();
+	}
+
 	const uint8_t *GetSoftwareVersion();
 
 	uint8_t GetActiveInputPorts() const {
@@ -217,6 +271,35 @@ public:
 	void SetMergeMode(uint8_t nPortIndex, ArtNetMerge tMergeMode);
 	ArtNetMerge GetMergeMode(uint8_t nPortIndex = 0) const;
 
+	/**
+	 * Number of sources merged on the port, 2 .. ARTNET_NODE_MAX_MERGE_SOURCES
+	 */
+	void SetMergeSources(uint8_t nPortIndex, uint8_t nSources);
+	uint8_t GetMergeSources(uint8_t nPortIndex = 0) const;
+
+	/**
+	 * Source buffers shared by the merging ports, set before Start
+	 */
+	void SetMergeBuffers(uint32_t nMergeBuffers) {
+		m_nMergeBuffers = nMergeBuffers;
+	}
+	uint32_t GetMergeBuffers() const {
+		return m_nMergeBuffers;
+	}
+
+	/**
+	 * Run handles up to nPackets received, as long as it is within nMicros,
+	 * so a burst is absorbed without starving the main loop.
+	 */
+	void SetDrain(uint32_t nPackets, uint32_t nMicros) {
+		m_nDrainPackets = (nPackets == 0) ? 1 : nPackets;
+		m_nDrainMicros = nMicros;
+	}
+
+	const struct TArtNetNodeRunStats& GetRunStats() const {
+		return m_RunStats;
+	}
+
 	void SetPortProtocol(uint8_t nPortIndex, TPortProtocol tPortProtocol);
 	TPortProtocol GetPortProtocol(uint8_t nPortIndex = 0) const;
 
@@ -308,12 +391,19 @@ private:
 	void HandleRdm();
 	void HandleIpProg();
 	void HandleDmxIn();
+	void HandlePacket();
 	void HandleTrigger();
 
 	uint16_t MakePortAddress(uint16_t, uint8_t nPage = 0);
+	void UpdatePortAddressMap();
 
+	int32_t GetSource(uint32_t nPortIndex, uint32_t nIp) const;
+	int32_t AddMergeSource(uint32_t nPortIndex, uint32_t nIp);
+	void RemoveSource(uint32_t nPortIndex, uint32_t nSource);
+	void RemoveSources(uint32_t nPortIndex);
 	bool IsMergedDmxDataChanged(uint8_t, const uint8_t *, uint16_t);
 	void CheckMergeTimeouts(uint8_t);
+	void UpdateMergeMode();
 	bool IsDmxDataChanged(uint8_t, const uint8_t *, uint16_t);
 
 	void SendPollRelply(bool);
@@ -326,6 +416,7 @@ private:
 	uint8_t m_nPages;
 	int32_t m_nHandle;
 	LightSet *m_pLightSet;
+	LightSetFrame m_LightSetFrame;
 
 	ArtNetTimeCode *m_pArtNetTimeCode;
 	ArtNetTimeSync *m_pArtNetTimeSync;
@@ -340,7 +431,7 @@ private:
 	struct TArtNetNode m_Node;
 	struct TArtNetNodeState m_State;
 
-	struct TArtNetPacket m_ArtNetPacket;
+	struct TArtNetPacketLease m_ArtNetPacket;
 	struct TArtPollReply m_PollReply;
 #if defined ( ENABLE_SENDDIAG )
 	struct TArtDiagData m_DiagData;
@@ -350,8 +441,16 @@ private:
 	struct TArtIpProgReply *m_pIpProgReply;
 
 	struct TOutputPort m_OutputPorts[ARTNET_NODE_MAX_PORTS_OUTPUT];
+	struct TPortAddressMap m_PortAddressMap;
 	struct TInputPort m_InputPorts[ARTNET_NODE_MAX_PORTS_INPUT];
 
+	LightSetMergePool m_MergePool;
+	uint32_t m_nMergeBuffers{ARTNET_NODE_MERGE_BUFFERS_DEFAULT};
+
+	uint32_t m_nDrainPackets{ARTNET_NODE_DRAIN_PACKETS_DEFAULT};
+	uint32_t m_nDrainMicros{ARTNET_NODE_DRAIN_MICROS_DEFAULT};
+	struct TArtNetNodeRunStats m_RunStats{0, 0, 0};
+
 	bool m_bDirectUpdate;
 
 	uint32_t m_nCurrentPacketMillis;
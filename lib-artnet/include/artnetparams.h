@@ -60,6 +60,8 @@ struct TArtNetParams {
 	bool bEnableNoChangeUpdate;								///< 1	118
 	uint8_t nDirection;										///< 1	119
 	uint32_t nDestinationIpPort[ArtNet::MAX_PORTS];			///< 16	135
+	uint8_t nMergeSources;									///< 1	136
+	uint16_t nMergeBuffers;									///< 2	138
 #if defined (__linux__) || defined (__APPLE__)
 }__attribute__((packed));
 #else
@@ -103,6 +105,8 @@ struct ArtnetParamsMask {
 	static constexpr auto PROTOCOL_D = (1U << 26);
 	static constexpr auto ENABLE_NO_CHANGE_OUTPUT = (1U << 27);
 	static constexpr auto DIRECTION = (1U << 28);
+	static constexpr auto MERGE_SOURCES = (1U << 29);
+	static constexpr auto MERGE_BUFFERS = (1U << 30);
 };
 
 class ArtNetParamsStore {
@@ -43,6 +43,8 @@ struct ArtNetParamsConst {
 	static const char NODE_OEM_VALUE[];
 	static const char NODE_NETWORK_DATA_LOSS_TIMEOUT[];
 	static const char NODE_DISABLE_MERGE_TIMEOUT[];
+	static const char NODE_MERGE_SOURCES[];
+	static const char NODE_MERGE_BUFFERS[];
 	static const char PROTOCOL[];
 	static const char PROTOCOL_PORT[ArtNet::MAX_PORTS][16];
 	static const char DIRECTION[];
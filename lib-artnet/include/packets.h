@@ -465,4 +465,14 @@ struct TArtNetPacket {
 	union UArtPacket ArtPacket;		///<
 };
 
+/**
+ * A received packet, parsed in place in the receive buffer of the network
+ */
+struct TArtNetPacketLease {
+	int length;						///<
+	uint32_t IPAddressFrom;			///<
+	TOpCodes OpCode;				///<
+	union UArtPacket *pArtPacket;	///<
+};
+
 #endif /* PACKETS_H_ */
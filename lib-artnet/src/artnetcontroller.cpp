@@ -42,6 +42,7 @@
 #include "debug.h"
 
 #define ARTNET_MIN_HEADER_SIZE		12
+#define ARTNET_UNICAST_MAX			40	///< If the number of universe subscribers exceeds 40 for a given universe, the transmitting device may broadcast.
 
 static uint16_t s_ActiveUniverses[ARTNET_POLL_TABLE_SIZE_UNIVERSES] __attribute__ ((aligned (4)));
 
@@ -167,12 +168,8 @@ void ArtNetController::HandleDmxOut(uint16_t nUniverse, const uint8_t *pDmxData,
 		}
 	}
 
-	// If the number of universe subscribers exceeds 40 for a given universe, the transmitting device may broadcast.
-
-	if (m_bUnicast && (nCount <= 40)) {
-		for (uint32_t nIndex = 0; nIndex < nCount; nIndex++) {
-			Network::Get()->SendTo(m_nHandle, m_pArtDmx, sizeof(struct TArtDmx), IpAddresses->pIpAddresses[nIndex], ArtNet::UDP_PORT);
-		}
+	if (m_bUnicast && (nCount <= ARTNET_UNICAST_MAX)) {
+		SendDmxUnicast(IpAddresses);
 
 		m_bDmxHandled = true;
 
@@ -180,7 +177,7 @@ void ArtNetController::HandleDmxOut(uint16_t nUniverse, const uint8_t *pDmxData,
 		return;
 	}
 
-	if (!m_bUnicast || (nCount > 40)) {
+	if (!m_bUnicast || (nCount > ARTNET_UNICAST_MAX)) {
 		Network::Get()->SendTo(m_nHandle, m_pArtDmx, sizeof(struct TArtDmx), m_tArtNetController.nIPAddressBroadcast, ArtNet::UDP_PORT);
 
 		m_bDmxHandled = true;
@@ -189,6 +186,24 @@ void ArtNetController::HandleDmxOut(uint16_t nUniverse, const uint8_t *pDmxData,
 	DEBUG_EXIT
 }
 
+/**
+ * One batched send for all the subscribers of the universe
+ */
+void ArtNetController::SendDmxUnicast(const struct TArtNetPollTableUniverses *IpAddresses) {
+	assert(IpAddresses->nCount <= ARTNET_UNICAST_MAX);
+
+	struct TNetworkSend aSend[ARTNET_UNICAST_MAX];
+
+	for (uint32_t nIndex = 0; nIndex < IpAddresses->nCount; nIndex++) {
+		aSend[nIndex].pBuffer = m_pArtDmx;
+		aSend[nIndex].nToIp = IpAddresses->pIpAddresses[nIndex];
+		aSend[nIndex].nLength = sizeof(struct TArtDmx);
+		aSend[nIndex].nRemotePort = ArtNet::UDP_PORT;
+	}
+
+	Network::Get()->SendToBatch(m_nHandle, aSend, IpAddresses->nCount);
+}
+
 void ArtNetController::HandleSync() {
 	if (m_bSynchronization && m_bDmxHandled) {
 		m_bDmxHandled = false;
@@ -216,7 +231,7 @@ void ArtNetController::HandleBlackout() {
 			}
 		}
 
-		if (m_bUnicast && (nCount <= 40)) {
+		if (m_bUnicast && (nCount <= ARTNET_UNICAST_MAX)) {
 			// The sequence number is used to ensure that ArtDmx packets are used in the correct order.
 			// This field is incremented in the range 0x01 to 0xff to allow the receiving node to resequence packets.
 			m_pArtDmx->Sequence++;
@@ -225,14 +240,12 @@ void ArtNetController::HandleBlackout() {
 				m_pArtDmx->Sequence = 1;
 			}
 
-			for (uint32_t nIndex = 0; nIndex < nCount; nIndex++) {
-				Network::Get()->SendTo(m_nHandle, m_pArtDmx, sizeof(struct TArtDmx), IpAddresses->pIpAddresses[nIndex], ArtNet::UDP_PORT);
-			}
+			SendDmxUnicast(IpAddresses);
 
 			continue;
 		}
 
-		if (!m_bUnicast || (nCount > 40)) {
+		if (!m_bUnicast || (nCount > ARTNET_UNICAST_MAX)) {
 			// The sequence number is used to ensure that ArtDmx packets are used in the correct order.
 			// This field is incremented in the range 0x01 to 0xff to allow the receiving node to resequence packets.
 			m_pArtDmx->Sequence++;
@@ -37,6 +37,7 @@
 #include "packets.h"
 
 #include "lightset.h"
+#include "lightsetdata.h"
 
 #include "artnetrdm.h"
 #include "artnettimecode.h"
@@ -65,7 +66,6 @@ union uip {
 static const uint8_t DEVICE_SOFTWARE_VERSION[] = { 1, 47 };
 
 #define ARTNET_MIN_HEADER_SIZE			12
-#define ARTNET_MERGE_TIMEOUT_SECONDS	10
 
 #define NETWORK_DATA_LOSS_TIMEOUT		10	///< Seconds
 
@@ -113,8 +113,11 @@ ArtNetNode::ArtNetNode(uint8_t nVersion, uint8_t nPages) :
 	for (uint32_t i = 0; i < ARTNET_NODE_MAX_PORTS_OUTPUT; i++) {
 		m_IsLightSetRunning[i] = false;
 		memset(&m_OutputPorts[i], 0 , sizeof(struct TOutputPort));
+		m_OutputPorts[i].nMaxSources = ARTNET_NODE_MERGE_SOURCES_DEFAULT;
 	}
 
+	UpdatePortAddressMap();
+
 	for (uint32_t i = 0; i < (ARTNET_NODE_MAX_PORTS_INPUT); i++) {
 		memset(&m_InputPorts[i], 0 , sizeof(struct TInputPort));
 		m_InputPorts[i].nDestinationIp = Network::Get()->GetIp() | ~(Network::Get()->GetNetmask());
@@ -169,9 +172,13 @@ void ArtNetNode::Start() {
 	FillDiagData();
 #endif
 
+	m_MergePool.Setup(m_nMergeBuffers);
+
 	m_nHandle = Network::Get()->Begin(ArtNet::UDP_PORT);
 	assert(m_nHandle != -1);
 
+	Network::Get()->SetQueueDepth(m_nHandle, ARTNET_NODE_QUEUE_DEPTH);
+
 	m_State.status = ARTNET_ON;
 
 	if (m_pArtNetDmx != nullptr) {
@@ -238,6 +245,8 @@ int ArtNetNode::SetUniverseSwitch(uint8_t nPortIndex, TArtNetPortDir dir, uint8_
 			}
 		}
 
+		UpdatePortAddressMap();
+
 		return ARTNET_EOK;
 	}
 
@@ -277,6 +286,8 @@ int ArtNetNode::SetUniverseSwitch(uint8_t nPortIndex, TArtNetPortDir dir, uint8_
 		}
 	}
 
+	UpdatePortAddressMap();
+
 	if ((m_pArtNet4Handler != nullptr) && (m_State.status != ARTNET_ON)) {
 		m_pArtNet4Handler->SetPort(nPortIndex, dir);
 	}
@@ -324,6 +335,8 @@ void ArtNetNode::SetSubnetSwitch(uint8_t nAddress, uint8_t nPage) {
 		m_OutputPorts[i].port.nPortAddress = MakePortAddress(m_OutputPorts[i].port.nPortAddress, (i / ArtNet::MAX_PORTS));
 	}
 
+	UpdatePortAddressMap();
+
 	if ((m_pArtNetStore != nullptr) && (m_State.status == ARTNET_ON)) {
 		if (nPage == 0) {
 			m_pArtNetStore->SaveSubnetSwitch(nAddress);
@@ -348,6 +361,8 @@ void ArtNetNode::SetNetSwitch(uint8_t nAddress, uint8_t nPage) {
 		m_OutputPorts[i].port.nPortAddress = MakePortAddress(m_OutputPorts[i].port.nPortAddress, (i / ArtNet::MAX_PORTS));
 	}
 
+	UpdatePortAddressMap();
+
 	if ((m_pArtNetStore != nullptr) && (m_State.status == ARTNET_ON)) {
 		if (nPage == 0) {
 			m_pArtNetStore->SaveNetSwitch(nAddress);
@@ -388,6 +403,36 @@ uint16_t ArtNetNode::MakePortAddress(uint16_t nCurrentAddress, uint8_t nPage) {
 	return newAddress;
 }
 
+void ArtNetNode::UpdatePortAddressMap() {
+	memset(&m_PortAddressMap, 0, sizeof(struct TPortAddressMap));
+
+	uint32_t nBlocks = 0;
+	uint32_t nFramePortMask = 0;
+
+	for (uint32_t i = 0; i < (ArtNet::MAX_PORTS * m_nPages); i++) {
+		if (!m_OutputPorts[i].bIsEnabled) {
+			continue;
+		}
+
+		if (m_OutputPorts[i].tPortProtocol == PORT_ARTNET_ARTNET) {
+			nFramePortMask |= (1U << i);
+		}
+
+		const uint16_t nPortAddress = m_OutputPorts[i].port.nPortAddress;
+		uint8_t &nBlockIndex = m_PortAddressMap.nBlockIndex[(nPortAddress >> 4) & 0x7FF];
+
+		if (nBlockIndex == 0) {
+			// All ports of a page share the same Net + Sub-Net
+			assert(nBlocks < ArtNet::MAX_PAGES);
+			nBlockIndex = static_cast<uint8_t>(++nBlocks);
+		}
+
+		m_PortAddressMap.nPortMask[nBlockIndex - 1][nPortAddress & 0x0F] |= (1U << i);
+	}
+
+	m_LightSetFrame.SetPortMask(nFramePortMask);
+}
+
 void ArtNetNode::SetMergeMode(uint8_t nPortIndex, ArtNetMerge tMergeMode) {
 	assert(nPortIndex < (ArtNet::MAX_PORTS * ArtNet::MAX_PAGES));
 
@@ -429,6 +474,8 @@ void ArtNetNode::SetPortProtocol(uint8_t nPortIndex, TPortProtocol tPortProtocol
 			m_OutputPorts[nPortIndex].port.nStatus &= (~GO_OUTPUT_IS_SACN);
 		}
 
+		UpdatePortAddressMap();
+
 		if (m_State.status == ARTNET_ON) {
 			if (nPortIndex < ArtNet::MAX_PORTS) {
 				if (m_pArtNetStore != nullptr) {
@@ -559,14 +606,8 @@ void ArtNetNode::SendPollRelply(bool bResponse) {
 			if (m_OutputPorts[nPortIndex].tPortProtocol == PORT_ARTNET_ARTNET) {
 				nStatus &= (~GO_DATA_IS_BEING_TRANSMITTED);
 
-				if (m_OutputPorts[nPortIndex].ipA != 0) {
-					if ((m_nCurrentPacketMillis - m_OutputPorts[nPortIndex].nMillisA) < 1000) {
-						nStatus |= GO_DATA_IS_BEING_TRANSMITTED;
-					}
-				}
-
-				if (m_OutputPorts[nPortIndex].ipB != 0) {
-					if ((m_nCurrentPacketMillis - m_OutputPorts[nPortIndex].nMillisB) < 1000) {
+				for (uint32_t nSource = 0; nSource < m_OutputPorts[nPortIndex].nSources; nSource++) {
+					if ((m_nCurrentPacketMillis - m_OutputPorts[nPortIndex].aSources[nSource].nMillis) < 1000) {
 						nStatus |= GO_DATA_IS_BEING_TRANSMITTED;
 					}
 				}
@@ -617,99 +658,22 @@ void ArtNetNode::SendPollRelply(bool bResponse) {
 }
 
 bool ArtNetNode::IsDmxDataChanged(uint8_t nPortId, const uint8_t *pData, uint16_t nLength) {
-	bool isChanged = false;
-
-	const uint8_t *pSrc = pData;
-	uint8_t *pDst = m_OutputPorts[nPortId].data;
-
 	if (nLength != m_OutputPorts[nPortId].nLength) {
 		m_OutputPorts[nPortId].nLength = nLength;
-
-		for (uint32_t i = 0; i < nLength; i++) {
-			*pDst++ = *pSrc++;
-		}
-
+		memcpy(m_OutputPorts[nPortId].data, pData, nLength);
+		lightset::data::SetAll(m_OutputPorts[nPortId].tDirty, nLength);
 		return true;
 	}
 
-	for (uint32_t i = 0; i < nLength; i++) {
-		if (*pDst != *pSrc) {
-			isChanged = true;
-		}
-		*pDst++ = *pSrc++;
-	}
+	struct TLightSetDirty tDirty;
+	const bool isChanged = lightset::data::Copy(m_OutputPorts[nPortId].data, pData, nLength, tDirty);
+	lightset::data::Add(m_OutputPorts[nPortId].tDirty, tDirty);
 
 	return isChanged;
 }
 
-bool ArtNetNode::IsMergedDmxDataChanged(uint8_t nPortId, const uint8_t *pData, uint16_t nLength) {
-	bool isChanged = false;
-
-	if (!m_State.IsMergeMode) {
-		m_State.IsMergeMode = true;
-		m_State.IsChanged = true;
-	}
-
-	m_OutputPorts[nPortId].port.nStatus |= GO_OUTPUT_IS_MERGING;
-
-
-	if (m_OutputPorts[nPortId].mergeMode == ArtNetMerge::HTP) {
-
-		if (nLength != m_OutputPorts[nPortId].nLength) {
-			m_OutputPorts[nPortId].nLength = nLength;
-			for (uint32_t i = 0; i < nLength; i++) {
-				uint8_t data = std::max(m_OutputPorts[nPortId].dataA[i], m_OutputPorts[nPortId].dataB[i]);
-				m_OutputPorts[nPortId].data[i] = data;
-			}
-			return true;
-		}
-
-		for (uint32_t i = 0; i < nLength; i++) {
-			uint8_t data = std::max(m_OutputPorts[nPortId].dataA[i], m_OutputPorts[nPortId].dataB[i]);
-			if (data != m_OutputPorts[nPortId].data[i]) {
-				m_OutputPorts[nPortId].data[i] = data;
-				isChanged = true;
-			}
-		}
-
-		return isChanged;
-	} else {
-		return IsDmxDataChanged(nPortId, pData, nLength);
-	}
-}
-
-void ArtNetNode::CheckMergeTimeouts(uint8_t nPortId) {
-	const uint32_t nTimeOutAMillis = m_nCurrentPacketMillis - m_OutputPorts[nPortId].nMillisA;
-
-	if (nTimeOutAMillis > (ARTNET_MERGE_TIMEOUT_SECONDS * 1000)) {
-		m_OutputPorts[nPortId].ipA = 0;
-		m_OutputPorts[nPortId].port.nStatus &= (~GO_OUTPUT_IS_MERGING);
-	}
-
-	const uint32_t nTimeOutBMillis = m_nCurrentPacketMillis - m_OutputPorts[nPortId].nMillisB;
-
-	if (nTimeOutBMillis > (ARTNET_MERGE_TIMEOUT_SECONDS * 1000)) {
-		m_OutputPorts[nPortId].ipB = 0;
-		m_OutputPorts[nPortId].port.nStatus &= (~GO_OUTPUT_IS_MERGING);
-	}
-
-	bool bIsMerging = false;
-
-	for (uint32_t i = 0; i < (ArtNet::MAX_PORTS * m_nPages); i++) {
-		bIsMerging |= ((m_OutputPorts[i].port.nStatus & GO_OUTPUT_IS_MERGING) != 0);
-	}
-
-	if (!bIsMerging) {
-		m_State.IsChanged = true;
-		m_State.IsMergeMode = false;
-#if defined ( ENABLE_SENDDIAG )
-		SendDiag("Leaving Merging Mode", ARTNET_DP_LOW);
-#endif
-	}
-}
-
 void ArtNetNode::HandlePoll() {
-	const struct TArtPoll *pArtPoll = &(m_ArtNetPacket.ArtPacket.ArtPoll);
+	const struct TArtPoll *pArtPoll = &(m_ArtNetPacket.pArtPacket->ArtPoll);
 
 	if (pArtPoll->TalkToMe & ArtNetTalkToMe::SEND_ARTP_ON_CHANGE) {
 		m_State.SendArtPollReplyOnChange = true;
@@ -751,95 +715,80 @@ void ArtNetNode::HandlePoll() {
 }
 
 void ArtNetNode::HandleDmx() {
-	const struct TArtDmx *pArtDmx = &(m_ArtNetPacket.ArtPacket.ArtDmx);
+	const struct TArtDmx *pArtDmx = &(m_ArtNetPacket.pArtPacket->ArtDmx);
 
 	uint32_t data_length = (static_cast<uint32_t>(pArtDmx->LengthHi << 8) & 0xff00) | pArtDmx->Length;
 	data_length = std::min(data_length, ArtNet::DMX_LENGTH);
 
-	for (uint32_t i = 0; i < (ArtNet::MAX_PORTS * m_nPages); i++) {
+	const uint16_t nPortAddress = pArtDmx->PortAddress;
+
+	if (__builtin_expect((nPortAddress & 0x8000) != 0, 0)) {
+		return;
+	}
+
+	const uint32_t nBlockIndex = m_PortAddressMap.nBlockIndex[nPortAddress >> 4];
 
-		if (m_OutputPorts[i].bIsEnabled && (m_OutputPorts[i].tPortProtocol == PORT_ARTNET_ARTNET) && (pArtDmx->PortAddress == m_OutputPorts[i].port.nPortAddress)) {
+	if (nBlockIndex == 0) {
+		return;
+	}
 
-			uint32_t ipA = m_OutputPorts[i].ipA;
-			uint32_t ipB = m_OutputPorts[i].ipB;
+	uint32_t nPortMask = m_PortAddressMap.nPortMask[nBlockIndex - 1][nPortAddress & 0x0F];
 
-			bool sendNewData = false;
+	while (nPortMask != 0) {
+		const uint32_t i = static_cast<uint32_t>(__builtin_ctz(nPortMask));
+		nPortMask &= (nPortMask - 1);
 
-			m_OutputPorts[i].port.nStatus = m_OutputPorts[i].port.nStatus | GO_DATA_IS_BEING_TRANSMITTED;
+		if (m_OutputPorts[i].tPortProtocol == PORT_ARTNET_ARTNET) {
+			const uint32_t nIp = m_ArtNetPacket.IPAddressFrom;
+			int32_t nSource = GetSource(i, nIp);
 
-			if (m_State.IsMergeMode) {
+			if ((m_OutputPorts[i].nSources > 1) || ((nSource < 0) && (m_OutputPorts[i].nSources != 0))) {
 				if (__builtin_expect((!m_State.bDisableMergeTimeout), 1)) {
 					CheckMergeTimeouts(i);
+					nSource = GetSource(i, nIp);
 				}
 			}
 
-			if (ipA == 0 && ipB == 0) {
+			bool sendNewData;
+
+			if (m_OutputPorts[i].nSources == 0) {
 #if defined ( ENABLE_SENDDIAG )
 				SendDiag("1. first packet recv on this port", ARTNET_DP_LOW);
 #endif
-				m_OutputPorts[i].ipA = m_ArtNetPacket.IPAddressFrom;
-				m_OutputPorts[i].nMillisA = m_nCurrentPacketMillis;
-				memcpy(&m_OutputPorts[i].dataA, pArtDmx->Data, data_length);
-				sendNewData = IsDmxDataChanged(i, pArtDmx->Data, data_length);
-			} else if (ipA == m_ArtNetPacket.IPAddressFrom && ipB == 0) {
+				nSource = 0;
+				m_OutputPorts[i].aSources[0].pData = nullptr;
+				m_OutputPorts[i].aSources[0].nIp = nIp;
+				m_OutputPorts[i].nSources = 1;
+			} else if (nSource < 0) {
 #if defined ( ENABLE_SENDDIAG )
-				SendDiag("2. continued transmission from the same ip (source A)", ARTNET_DP_LOW);
+				SendDiag("2. new source, start the merge", ARTNET_DP_LOW);
 #endif
-				m_OutputPorts[i].nMillisA = m_nCurrentPacketMillis;
-				memcpy(&m_OutputPorts[i].dataA, pArtDmx->Data, data_length);
-				sendNewData = IsDmxDataChanged(i, pArtDmx->Data, data_length);
-			} else if (ipA == 0 && ipB == m_ArtNetPacket.IPAddressFrom) {
+				nSource = AddMergeSource(i, nIp);
+
+				if (nSource < 0) {
 #if defined ( ENABLE_SENDDIAG )
-				SendDiag("3. continued transmission from the same ip (source B)", ARTNET_DP_LOW);
+					SendDiag("3. No merge source available, discarding data", ARTNET_DP_LOW);
 #endif
-				m_OutputPorts[i].nMillisB = m_nCurrentPacketMillis;
-				memcpy(&m_OutputPorts[i].dataB, pArtDmx->Data, data_length);
+					continue;
+				}
+			}
+
+			m_LightSetFrame.PortBegin(i, m_nCurrentPacketMillis);
+
+			m_OutputPorts[i].port.nStatus = m_OutputPorts[i].port.nStatus | GO_DATA_IS_BEING_TRANSMITTED;
+
+			struct TArtNetMergeSource &source = m_OutputPorts[i].aSources[nSource];
+			source.nMillis = m_nCurrentPacketMillis;
+
+			if (m_OutputPorts[i].nSources == 1) {
 				sendNewData = IsDmxDataChanged(i, pArtDmx->Data, data_length);
-			} else if (ipA != m_ArtNetPacket.IPAddressFrom && ipB == 0) {
-#if defined ( ENABLE_SENDDIAG )
-				SendDiag("4. new source, start the merge", ARTNET_DP_LOW);
-#endif
-				m_OutputPorts[i].ipB = m_ArtNetPacket.IPAddressFrom;
-				m_OutputPorts[i].nMillisB = m_nCurrentPacketMillis;
-				memcpy(&m_OutputPorts[i].dataB, pArtDmx->Data, data_length);
-				sendNewData = IsMergedDmxDataChanged(i, m_OutputPorts[i].dataB, data_length);
-			} else if (ipA == 0 && ipB != m_ArtNetPacket.IPAddressFrom) {
-#if defined ( ENABLE_SENDDIAG )
-				SendDiag("5. new source, start the merge", ARTNET_DP_LOW);
-#endif
-				m_OutputPorts[i].ipA = m_ArtNetPacket.IPAddressFrom;
-				m_OutputPorts[i].nMillisA = m_nCurrentPacketMillis;
-				memcpy(&m_OutputPorts[i].dataA, pArtDmx->Data, data_length);
-				sendNewData = IsMergedDmxDataChanged(i, m_OutputPorts[i].dataA, data_length);
-			} else if (ipA == m_ArtNetPacket.IPAddressFrom && ipB != m_ArtNetPacket.IPAddressFrom) {
-#if defined ( ENABLE_SENDDIAG )
-				SendDiag("6. continue merge", ARTNET_DP_LOW);
-#endif
-				m_OutputPorts[i].nMillisA = m_nCurrentPacketMillis;
-				memcpy(&m_OutputPorts[i].dataA, pArtDmx->Data, data_length);
-				sendNewData = IsMergedDmxDataChanged(i, m_OutputPorts[i].dataA, data_length);
-			} else if (ipA != m_ArtNetPacket.IPAddressFrom && ipB == m_ArtNetPacket.IPAddressFrom) {
-#if defined ( ENABLE_SENDDIAG )
-				SendDiag("7. continue merge", ARTNET_DP_LOW);
-#endif
-				m_OutputPorts[i].nMillisB = m_nCurrentPacketMillis;
-				memcpy(&m_OutputPorts[i].dataB, pArtDmx->Data, data_length);
-				sendNewData = IsMergedDmxDataChanged(i, m_OutputPorts[i].dataB, data_length);
-			} else if (ipA == m_ArtNetPacket.IPAddressFrom && ipB == m_ArtNetPacket.IPAddressFrom) {
-#if defined ( ENABLE_SENDDIAG )
-				SendDiag("8. Source matches both buffers, this shouldn't be happening!", ARTNET_DP_LOW);
-#endif
-				return;
-			} else if (ipA != m_ArtNetPacket.IPAddressFrom && ipB != m_ArtNetPacket.IPAddressFrom) {
-#if defined ( ENABLE_SENDDIAG )
-				SendDiag("9. More than two sources, discarding data", ARTNET_DP_LOW);
-#endif
-				return;
 			} else {
-#if defined ( ENABLE_SENDDIAG )
-				SendDiag("0. No cases matched, this shouldn't happen!", ARTNET_DP_LOW);
-#endif
-				return;
+				memcpy(source.pData, pArtDmx->Data, data_length);
+				if (data_length < source.nLength) {
+					memset(&source.pData[data_length], 0, source.nLength - data_length);
+				}
+				source.nLength = static_cast<uint16_t>(data_length);
+				sendNewData = IsMergedDmxDataChanged(i, pArtDmx->Data, data_length);
 			}
 
 			if (sendNewData || m_bDirectUpdate) {
@@ -847,7 +796,8 @@ void ArtNetNode::HandleDmx() {
 #if defined ( ENABLE_SENDDIAG )
 					SendDiag("Send new data", ARTNET_DP_LOW);
 #endif
-					m_pLightSet->SetData(i, m_OutputPorts[i].data, m_OutputPorts[i].nLength);
+					m_LightSetFrame.SetData(i, m_OutputPorts[i].data, m_OutputPorts[i].nLength, m_OutputPorts[i].tDirty);
+					lightset::data::SetClean(m_OutputPorts[i].tDirty);
 
 					if(!m_IsLightSetRunning[i]) {
 						m_pLightSet->Start(i);
@@ -866,6 +816,8 @@ void ArtNetNode::HandleDmx() {
 #endif
 			}
 
+			m_LightSetFrame.PortEnd(i);
+
 			m_State.bIsReceivingDmx = true;
 		}
 	}
@@ -880,7 +832,8 @@ void ArtNetNode::HandleSync() {
 #if defined ( ENABLE_SENDDIAG )
 			SendDiag("Send pending data", ARTNET_DP_LOW);
 #endif
-			m_pLightSet->SetData(i, m_OutputPorts[i].data, 	m_OutputPorts[i].nLength);
+			m_LightSetFrame.SetData(i, m_OutputPorts[i].data, m_OutputPorts[i].nLength, m_OutputPorts[i].tDirty);
+			lightset::data::SetClean(m_OutputPorts[i].tDirty);
 
 			if(!m_IsLightSetRunning[i]) {
 				m_pLightSet->Start(i);
@@ -890,10 +843,13 @@ void ArtNetNode::HandleSync() {
 			m_OutputPorts[i].IsDataPending = false;
 		}
 	}
+
+	// ArtSync is the frame boundary
+	m_LightSetFrame.Commit();
 }
 
 void ArtNetNode::HandleAddress() {
-	const struct TArtAddress *pArtAddress = &(m_ArtNetPacket.ArtPacket.ArtAddress);
+	const struct TArtAddress *pArtAddress = &(m_ArtNetPacket.pArtPacket->ArtAddress);
 	uint8_t nPort = 0xFF;
 
 	m_State.reportCode = ARTNET_RCPOWEROK;
@@ -941,7 +897,7 @@ void ArtNetNode::HandleAddress() {
 		// If Node is currently in merge mode, cancel merge mode upon receipt of next ArtDmx packet.
 		m_State.IsMergeMode = false;
 		for (uint32_t i = 0; i < (ArtNet::MAX_PORTS * m_nPages); i++) {
-			m_OutputPorts[i].port.nStatus &= (~GO_OUTPUT_IS_MERGING);
+			RemoveSources(i);
 		}
 		break;
 
@@ -995,8 +951,11 @@ void ArtNetNode::HandleAddress() {
 			m_OutputPorts[nPort].data[i] = 0;
 		}
 		m_OutputPorts[nPort].nLength = ArtNet::DMX_LENGTH;
+		lightset::data::SetAll(m_OutputPorts[nPort].tDirty, ArtNet::DMX_LENGTH);
 		if (m_OutputPorts[nPort].tPortProtocol == PORT_ARTNET_ARTNET) {
-			m_pLightSet->SetData(nPort, m_OutputPorts[nPort].data, m_OutputPorts[nPort].nLength);
+			m_LightSetFrame.SetData(nPort, m_OutputPorts[nPort].data, m_OutputPorts[nPort].nLength, m_OutputPorts[nPort].tDirty);
+			lightset::data::SetClean(m_OutputPorts[nPort].tDirty);
+			m_LightSetFrame.Commit();
 		}
 		break;
 
@@ -1029,13 +988,12 @@ void ArtNetNode::SetNetworkDataLossCondition() {
 
 		m_OutputPorts[i].port.nStatus &= (~GO_DATA_IS_BEING_TRANSMITTED);
 		m_OutputPorts[i].nLength = 0;
-		m_OutputPorts[i].ipA = 0;
-		m_OutputPorts[i].ipB = 0;
+		RemoveSources(i);
 	}
 }
 
 void ArtNetNode::GetType() {
-	char *data = reinterpret_cast<char*>(&(m_ArtNetPacket.ArtPacket));
+	char *data = reinterpret_cast<char*>(m_ArtNetPacket.pArtPacket);
 
 	if (m_ArtNetPacket.length < ARTNET_MIN_HEADER_SIZE) {
 		m_ArtNetPacket.OpCode = OP_NOT_DEFINED;
@@ -1054,53 +1012,7 @@ void ArtNetNode::GetType() {
 	}
 }
 
-void ArtNetNode::Run() {
-	uint16_t nForeignPort;
-
-	const int nBytesReceived = Network::Get()->RecvFrom(m_nHandle, &(m_ArtNetPacket.ArtPacket), sizeof(m_ArtNetPacket.ArtPacket), &m_ArtNetPacket.IPAddressFrom, &nForeignPort);
-
-	m_nCurrentPacketMillis = Hardware::Get()->Millis();
-
-	if (__builtin_expect((nBytesReceived == 0), 1)) {
-		if ((m_State.nNetworkDataLossTimeoutMillis != 0) && ((m_nCurrentPacketMillis - m_nPreviousPacketMillis) >= m_State.nNetworkDataLossTimeoutMillis)) {
-			SetNetworkDataLossCondition();
-		}
-
-		if (m_State.SendArtPollReplyOnChange) {
-			bool doSend = m_State.IsChanged;
-			if (m_pArtNet4Handler != nullptr) {
-				doSend |= m_pArtNet4Handler->IsStatusChanged();
-			}
-			if (doSend) {
-				SendPollRelply(false);
-			}
-		}
-
-		if ((m_nCurrentPacketMillis - m_nPreviousPacketMillis) >= (1 * 1000)) {
-			if (((m_Node.Status1 & STATUS1_INDICATOR_MASK) == STATUS1_INDICATOR_NORMAL_MODE)) {
-				LedBlink::Get()->SetMode(LEDBLINK_MODE_NORMAL);
-				m_State.bIsReceivingDmx = false;
-			}
-		}
-
-		if (m_pArtNetDmx != nullptr) {
-			HandleDmxIn();
-
-			if (((m_Node.Status1 & STATUS1_INDICATOR_MASK) == STATUS1_INDICATOR_NORMAL_MODE)) {
-				if (m_State.bIsReceivingDmx) {
-					LedBlink::Get()->SetMode(LEDBLINK_MODE_DATA);
-				} else {
-					LedBlink::Get()->SetMode(LEDBLINK_MODE_NORMAL);
-				}
-			}
-		}
-
-		return;
-	}
-
-	m_ArtNetPacket.length = nBytesReceived;
-	m_nPreviousPacketMillis = m_nCurrentPacketMillis;
-
+void ArtNetNode::HandlePacket() {
 	GetType();
 
 	if (m_State.IsSynchronousMode) {
@@ -1166,6 +1078,120 @@ void ArtNetNode::Run() {
 		// Just skip ... no error
 		break;
 	}
+}
+
+uint32_t ArtNetNode::GetTimeoutMillis() {
+	if (m_pArtNetDmx != nullptr) {
+		return 0;
+	}
+
+	if (m_State.SendArtPollReplyOnChange) {
+		if ((m_pArtNet4Handler != nullptr) && m_pArtNet4Handler->IsStatusChanged()) {
+			m_State.IsChanged = true;
+		}
+
+		if (m_State.IsChanged) {
+			return 0;
+		}
+	}
+
+	const uint32_t nMillis = Hardware::Get()->Millis();
+	const uint32_t nElapsed = nMillis - m_nPreviousPacketMillis;
+
+	uint32_t nTimeoutMillis = m_LightSetFrame.GetTimeoutMillis(nMillis);
+
+	if ((m_State.nNetworkDataLossTimeoutMillis != 0) && (nElapsed < m_State.nNetworkDataLossTimeoutMillis)) {
+		nTimeoutMillis = std::min(nTimeoutMillis, m_State.nNetworkDataLossTimeoutMillis - nElapsed);
+	}
+
+	if (m_State.bIsReceivingDmx && (nElapsed < 1000)) {
+		nTimeoutMillis = std::min(nTimeoutMillis, 1000 - nElapsed);
+	}
+
+	return nTimeoutMillis;
+}
+
+void ArtNetNode::Run() {
+	uint16_t nForeignPort;
+
+	void *pBuffer;
+	int nBytesReceived = Network::Get()->RecvLease(m_nHandle, &pBuffer, &m_ArtNetPacket.IPAddressFrom, &nForeignPort);
+
+	m_nCurrentPacketMillis = Hardware::Get()->Millis();
+
+	m_LightSetFrame.Run(m_nCurrentPacketMillis);
+
+	if (__builtin_expect((nBytesReceived == 0), 1)) {
+		if ((m_State.nNetworkDataLossTimeoutMillis != 0) && ((m_nCurrentPacketMillis - m_nPreviousPacketMillis) >= m_State.nNetworkDataLossTimeoutMillis)) {
+			SetNetworkDataLossCondition();
+		}
+
+		if (m_State.SendArtPollReplyOnChange) {
+			bool doSend = m_State.IsChanged;
+			if (m_pArtNet4Handler != nullptr) {
+				doSend |= m_pArtNet4Handler->IsStatusChanged();
+			}
+			if (doSend) {
+				SendPollRelply(false);
+			}
+		}
+
+		if ((m_nCurrentPacketMillis - m_nPreviousPacketMillis) >= (1 * 1000)) {
+			if (((m_Node.Status1 & STATUS1_INDICATOR_MASK) == STATUS1_INDICATOR_NORMAL_MODE)) {
+				LedBlink::Get()->SetMode(LEDBLINK_MODE_NORMAL);
+				m_State.bIsReceivingDmx = false;
+			}
+		}
+
+		if (m_pArtNetDmx != nullptr) {
+			HandleDmxIn();
+
+			if (((m_Node.Status1 & STATUS1_INDICATOR_MASK) == STATUS1_INDICATOR_NORMAL_MODE)) {
+				if (m_State.bIsReceivingDmx) {
+					LedBlink::Get()->SetMode(LEDBLINK_MODE_DATA);
+				} else {
+					LedBlink::Get()->SetMode(LEDBLINK_MODE_NORMAL);
+				}
+			}
+		}
+
+		return;
+	}
+
+	const uint32_t nMicrosBegin = Hardware::Get()->Micros();
+	uint32_t nPackets = 0;
+
+	// Drain the receive queue, bounded by the number of packets and the time
+	for (;;) {
+		m_ArtNetPacket.length = nBytesReceived;
+		m_ArtNetPacket.pArtPacket = reinterpret_cast<union UArtPacket*>(pBuffer);
+		m_nPreviousPacketMillis = m_nCurrentPacketMillis;
+
+		HandlePacket();
+
+		Network::Get()->Release(m_nHandle);
+
+		nPackets++;
+
+		if ((nPackets >= m_nDrainPackets) || ((Hardware::Get()->Micros() - nMicrosBegin) >= m_nDrainMicros)) {
+			m_RunStats.nBurstLimited++;
+			break;
+		}
+
+		Network::Get()->Run();
+
+		nBytesReceived = Network::Get()->RecvLease(m_nHandle, &pBuffer, &m_ArtNetPacket.IPAddressFrom, &nForeignPort);
+
+		if (nBytesReceived == 0) {
+			break;
+		}
+	}
+
+	m_RunStats.nPackets += nPackets;
+
+	if (nPackets > m_RunStats.nBurstMax) {
+		m_RunStats.nBurstMax = nPackets;
+	}
 
 	if (m_pArtNetDmx != nullptr) {
 		HandleDmxIn();
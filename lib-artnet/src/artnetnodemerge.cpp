@@ -0,0 +1,213 @@
+/**
+ * @file artnetnodemerge.cpp
+ *
+ */
+/* Copyright (C) 2020 by Arjan van Vught mailto:info@orangepi-dmx.nl
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include <stdint.h>
+#include <string.h>
+#include <cassert>
+
+#include "artnetnode.h"
+#include "artnet.h"
+
+#include "lightsetdata.h"
+
+#include "debug.h"
+
+#define ARTNET_MERGE_TIMEOUT_SECONDS	10
+
+void ArtNetNode::SetMergeSources(uint8_t nPortIndex, uint8_t nSources) {
+	assert(nPortIndex < ARTNET_NODE_MAX_PORTS_OUTPUT);
+
+	if (nSources < 2) {
+		nSources = 2;
+	} else if (nSources > ARTNET_NODE_MAX_MERGE_SOURCES) {
+		nSources = ARTNET_NODE_MAX_MERGE_SOURCES;
+	}
+
+	RemoveSources(nPortIndex);
+	m_OutputPorts[nPortIndex].nMaxSources = nSources;
+}
+
+uint8_t ArtNetNode::GetMergeSources(uint8_t nPortIndex) const {
+	assert(nPortIndex < ARTNET_NODE_MAX_PORTS_OUTPUT);
+
+	return m_OutputPorts[nPortIndex].nMaxSources;
+}
+
+int32_t ArtNetNode::GetSource(uint32_t nPortIndex, uint32_t nIp) const {
+	const struct TOutputPort &port = m_OutputPorts[nPortIndex];
+
+	for (uint32_t nSource = 0; nSource < port.nSources; nSource++) {
+		if (port.aSources[nSource].nIp == nIp) {
+			return static_cast<int32_t>(nSource);
+		}
+	}
+
+	return -1;
+}
+
+/**
+ * The port starts or extends the merge. The data of a single source is not buffered,
+ * it is in the port data and is copied into a pool buffer when the merge starts.
+ */
+int32_t ArtNetNode::AddMergeSource(uint32_t nPortIndex, uint32_t nIp) {
+	struct TOutputPort &port = m_OutputPorts[nPortIndex];
+
+	assert(port.nSources != 0);
+
+	if (port.nSources >= port.nMaxSources) {
+		return -1;
+	}
+
+	if (port.nSources == 1) {
+		struct TArtNetMergeSource &first = port.aSources[0];
+		assert(first.pData == nullptr);
+
+		first.pData = m_MergePool.Get();
+
+		if (first.pData == nullptr) {
+			return -1;
+		}
+
+		first.nLength = port.nLength;
+		memcpy(first.pData, port.data, port.nLength);
+	}
+
+	struct TArtNetMergeSource &source = port.aSources[port.nSources];
+
+	source.pData = m_MergePool.Get();
+
+	if (source.pData == nullptr) {
+		if (port.nSources == 1) {
+			m_MergePool.Put(port.aSources[0].pData);
+			port.aSources[0].pData = nullptr;
+		}
+		return -1;
+	}
+
+	source.nIp = nIp;
+	source.nLength = 0;
+
+	return static_cast<int32_t>(port.nSources++);
+}
+
+void ArtNetNode::RemoveSource(uint32_t nPortIndex, uint32_t nSource) {
+	struct TOutputPort &port = m_OutputPorts[nPortIndex];
+
+	assert(nSource < port.nSources);
+
+	if (port.aSources[nSource].pData != nullptr) {
+		m_MergePool.Put(port.aSources[nSource].pData);
+	}
+
+	port.nSources--;
+	port.aSources[nSource] = port.aSources[port.nSources];
+	port.aSources[port.nSources].pData = nullptr;
+
+	if (port.nSources <= 1) {
+		// A single source is not buffered
+		if ((port.nSources == 1) && (port.aSources[0].pData != nullptr)) {
+			m_MergePool.Put(port.aSources[0].pData);
+			port.aSources[0].pData = nullptr;
+		}
+
+		port.port.nStatus &= (~GO_OUTPUT_IS_MERGING);
+	}
+}
+
+void ArtNetNode::RemoveSources(uint32_t nPortIndex) {
+	while (m_OutputPorts[nPortIndex].nSources != 0) {
+		RemoveSource(nPortIndex, m_OutputPorts[nPortIndex].nSources - 1U);
+	}
+}
+
+bool ArtNetNode::IsMergedDmxDataChanged(uint8_t nPortId, const uint8_t *pData, uint16_t nLength) {
+	if (!m_State.IsMergeMode) {
+		m_State.IsMergeMode = true;
+		m_State.IsChanged = true;
+	}
+
+	struct TOutputPort &port = m_OutputPorts[nPortId];
+
+	port.port.nStatus |= GO_OUTPUT_IS_MERGING;
+
+	if (port.mergeMode == ArtNetMerge::LTP) {
+		return IsDmxDataChanged(nPortId, pData, nLength);
+	}
+
+	// The sources are merged over the longest, missing slots of the shorter sources are 0
+	const uint8_t *pSources[ARTNET_NODE_MAX_MERGE_SOURCES];
+	uint16_t nMergeLength = 0;
+
+	for (uint32_t nSource = 0; nSource < port.nSources; nSource++) {
+		pSources[nSource] = port.aSources[nSource].pData;
+		if (port.aSources[nSource].nLength > nMergeLength) {
+			nMergeLength = port.aSources[nSource].nLength;
+		}
+	}
+
+	struct TLightSetDirty tDirty;
+	const bool isChanged = lightset::data::MergeHtp(port.data, pSources, port.nSources, nMergeLength, tDirty);
+
+	if (nMergeLength != port.nLength) {
+		port.nLength = nMergeLength;
+		lightset::data::SetAll(port.tDirty, nMergeLength);
+		return true;
+	}
+
+	lightset::data::Add(port.tDirty, tDirty);
+	return isChanged;
+}
+
+void ArtNetNode::CheckMergeTimeouts(uint8_t nPortId) {
+	struct TOutputPort &port = m_OutputPorts[nPortId];
+
+	const bool bWasMerging = (port.nSources > 1);
+
+	for (uint32_t nSource = port.nSources; nSource-- > 0;) {
+		if ((m_nCurrentPacketMillis - port.aSources[nSource].nMillis) > (ARTNET_MERGE_TIMEOUT_SECONDS * 1000)) {
+			RemoveSource(nPortId, nSource);
+		}
+	}
+
+	if (bWasMerging && (port.nSources <= 1)) {
+		UpdateMergeMode();
+	}
+}
+
+void ArtNetNode::UpdateMergeMode() {
+	bool bIsMerging = false;
+
+	for (uint32_t i = 0; i < (ArtNet::MAX_PORTS * m_nPages); i++) {
+		bIsMerging |= ((m_OutputPorts[i].port.nStatus & GO_OUTPUT_IS_MERGING) != 0);
+	}
+
+	if (!bIsMerging && m_State.IsMergeMode) {
+		m_State.IsChanged = true;
+		m_State.IsMergeMode = false;
+#if defined ( ENABLE_SENDDIAG )
+		SendDiag("Leaving Merging Mode", ARTNET_DP_LOW);
+#endif
+	}
+}
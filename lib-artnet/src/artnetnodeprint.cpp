@@ -56,7 +56,7 @@ void ArtNetNode::Print() {
 				const uint8_t nNet = m_Node.NetSwitch[nPortIndex / ArtNet::MAX_PORTS];
 				const uint8_t nSubSwitch = m_Node.SubSwitch[nPortIndex / ArtNet::MAX_PORTS];
 
-				printf("  Port %2d %d:%-3d[%2x] [%s]", nPortIndex, nNet, nSubSwitch * 16 + nAddress, nSubSwitch * 16 + nAddress, ArtNet::GetMergeMode(m_OutputPorts[nPortIndex].mergeMode, true));
+				printf("  Port %2d %d:%-3d[%2x] [%s:%d]", nPortIndex, nNet, nSubSwitch * 16 + nAddress, nSubSwitch * 16 + nAddress, ArtNet::GetMergeMode(m_OutputPorts[nPortIndex].mergeMode, true), m_OutputPorts[nPortIndex].nMaxSources);
 				if (m_nVersion == 4) {
 					printf(" {%s}\n", ArtNet::GetProtocolMode(m_OutputPorts[nPortIndex].tPortProtocol, true));
 				} else {
@@ -68,6 +68,8 @@ void ArtNetNode::Print() {
 		if (m_bDirectUpdate) {
 			printf(" Direct update : Yes\n");
 		}
+
+		printf(" Merge buffers : %d\n", static_cast<int>(m_nMergeBuffers));
 	}
 
 	if (m_State.nActiveInputPorts != 0) {
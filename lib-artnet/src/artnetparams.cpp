@@ -69,6 +69,8 @@ ArtNetParams::ArtNetParams(ArtNetParamsStore *pArtNetParamsStore): m_pArtNetPara
 	m_tArtNetParams.aOemValue[0] = ArtNetConst::OEM_ID[1];
 	m_tArtNetParams.aOemValue[1] = ArtNetConst::OEM_ID[0];
 	m_tArtNetParams.nDirection = ARTNET_OUTPUT_PORT;
+	m_tArtNetParams.nMergeSources = ARTNET_NODE_MERGE_SOURCES_DEFAULT;
+	m_tArtNetParams.nMergeBuffers = ARTNET_NODE_MERGE_BUFFERS_DEFAULT;
 
 	DEBUG_EXIT
 }
@@ -178,6 +180,20 @@ void ArtNetParams::callbackFunction(const char *pLine) {
 		return;
 	}
 
+	if (Sscan::Uint8(pLine, ArtNetParamsConst::NODE_MERGE_SOURCES, nValue8) == Sscan::OK) {
+		if ((nValue8 >= 2) && (nValue8 <= ARTNET_NODE_MAX_MERGE_SOURCES)) {
+			m_tArtNetParams.nMergeSources = nValue8;
+			m_tArtNetParams.nSetList |= ArtnetParamsMask::MERGE_SOURCES;
+		}
+		return;
+	}
+
+	if (Sscan::Uint16(pLine, ArtNetParamsConst::NODE_MERGE_BUFFERS, nValue16) == Sscan::OK) {
+		m_tArtNetParams.nMergeBuffers = nValue16;
+		m_tArtNetParams.nSetList |= ArtnetParamsMask::MERGE_BUFFERS;
+		return;
+	}
+
 	if (Sscan::Uint8(pLine, ArtNetParamsConst::NET, nValue8) == Sscan::OK) {
 		m_tArtNetParams.nNet = nValue8;
 		m_tArtNetParams.nSetList |= ArtnetParamsMask::NET;
@@ -44,6 +44,8 @@ const char ArtNetParamsConst::NODE_MANUFACTURER_ID[] = "manufacturer_id";
 const char ArtNetParamsConst::NODE_OEM_VALUE[] = "oem_value";
 const char ArtNetParamsConst::NODE_NETWORK_DATA_LOSS_TIMEOUT[] = "network_data_loss_timeout";
 const char ArtNetParamsConst::NODE_DISABLE_MERGE_TIMEOUT[] = "disable_merge_timeout";
+const char ArtNetParamsConst::NODE_MERGE_SOURCES[] = "merge_sources";
+const char ArtNetParamsConst::NODE_MERGE_BUFFERS[] = "merge_buffers";
 
 const char ArtNetParamsConst::PROTOCOL[] = "protocol";
 const char ArtNetParamsConst::PROTOCOL_PORT[ArtNet::MAX_PORTS][16] = { "protocol_port_a", "protocol_port_b", "protocol_port_c", "protocol_port_d" };
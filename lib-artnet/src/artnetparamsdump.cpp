@@ -95,6 +95,14 @@ void ArtNetParams::Dump() {
 		printf(" %s=%d [%s]\n", ArtNetParamsConst::NODE_DISABLE_MERGE_TIMEOUT, static_cast<int>(m_tArtNetParams.bDisableMergeTimeout), BOOL2STRING::Get(m_tArtNetParams.bDisableMergeTimeout));
 	}
 
+	if(isMaskSet(ArtnetParamsMask::MERGE_SOURCES)) {
+		printf(" %s=%d\n", ArtNetParamsConst::NODE_MERGE_SOURCES, m_tArtNetParams.nMergeSources);
+	}
+
+	if(isMaskSet(ArtnetParamsMask::MERGE_BUFFERS)) {
+		printf(" %s=%d\n", ArtNetParamsConst::NODE_MERGE_BUFFERS, m_tArtNetParams.nMergeBuffers);
+	}
+
 	for (unsigned i = 0; i < ArtNet::MAX_PORTS; i++) {
 		if (isMaskSet(ArtnetParamsMask::UNIVERSE_A << i)) {
 			printf(" %s=%d\n", LightSetConst::PARAMS_UNIVERSE_PORT[i], m_tArtNetParams.nUniversePort[i]);
@@ -89,6 +89,8 @@ void ArtNetParams::Builder(const struct TArtNetParams *pArtNetParams, char *pBuf
 
 	builder.Add(ArtNetParamsConst::NODE_NETWORK_DATA_LOSS_TIMEOUT, m_tArtNetParams.nNetworkTimeout, isMaskSet(ArtnetParamsMask::NETWORK_TIMEOUT));
 	builder.Add(ArtNetParamsConst::NODE_DISABLE_MERGE_TIMEOUT, m_tArtNetParams.bDisableMergeTimeout, isMaskSet(ArtnetParamsMask::MERGE_TIMEOUT));
+	builder.Add(ArtNetParamsConst::NODE_MERGE_SOURCES, m_tArtNetParams.nMergeSources, isMaskSet(ArtnetParamsMask::MERGE_SOURCES));
+	builder.Add(ArtNetParamsConst::NODE_MERGE_BUFFERS, m_tArtNetParams.nMergeBuffers, isMaskSet(ArtnetParamsMask::MERGE_BUFFERS));
 
 	builder.Add(LightSetConst::PARAMS_ENABLE_NO_CHANGE_UPDATE, m_tArtNetParams.bEnableNoChangeUpdate, isMaskSet(ArtnetParamsMask::ENABLE_NO_CHANGE_OUTPUT));
 
@@ -68,6 +68,16 @@ void ArtNetParams::Set(ArtNetNode *pArtNetNode) {
 		pArtNetNode->SetDisableMergeTimeout(m_tArtNetParams.bDisableMergeTimeout);
 	}
 
+	if (isMaskSet(ArtnetParamsMask::MERGE_BUFFERS)) {
+		pArtNetNode->SetMergeBuffers(m_tArtNetParams.nMergeBuffers);
+	}
+
+	if (isMaskSet(ArtnetParamsMask::MERGE_SOURCES)) {
+		for (uint32_t nPortIndex = 0; nPortIndex < ARTNET_NODE_MAX_PORTS_OUTPUT; nPortIndex++) {
+			pArtNetNode->SetMergeSources(static_cast<uint8_t>(nPortIndex), m_tArtNetParams.nMergeSources);
+		}
+	}
+
 	unsigned i;
 
 	for (i = 0; i < ArtNet::MAX_PORTS; i++) {
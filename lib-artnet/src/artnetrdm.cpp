@@ -37,7 +37,7 @@
 #include "artnetnode_internal.h"
 
 void ArtNetNode::HandleTodControl() {
-	const struct TArtTodControl *pArtTodControl =  &(m_ArtNetPacket.ArtPacket.ArtTodControl);
+	const struct TArtTodControl *pArtTodControl =  &(m_ArtNetPacket.pArtPacket->ArtTodControl);
 	const uint16_t portAddress = static_cast<uint16_t>((pArtTodControl->Net << 8)) | static_cast<uint16_t>((pArtTodControl->Address));
 
 	for (uint32_t i = 0; i < ArtNet::MAX_PORTS; i++) {
@@ -61,7 +61,7 @@ void ArtNetNode::HandleTodControl() {
 }
 
 void ArtNetNode::HandleTodRequest() {
-	const struct TArtTodRequest *pArtTodRequest = &(m_ArtNetPacket.ArtPacket.ArtTodRequest);
+	const struct TArtTodRequest *pArtTodRequest = &(m_ArtNetPacket.pArtPacket->ArtTodRequest);
 	const uint16_t portAddress = static_cast<uint16_t>((pArtTodRequest->Net << 8)) | static_cast<uint16_t>((pArtTodRequest->Address[0]));
 
 	for (uint32_t i = 0; i < ArtNet::MAX_PORTS; i++) {
@@ -115,7 +115,7 @@ void ArtNetNode::SetRdmHandler(ArtNetRdm *pArtNetTRdm, bool IsResponder) {
 }
 
 void ArtNetNode::HandleRdm() {
-	struct TArtRdm *pArtRdm = &(m_ArtNetPacket.ArtPacket.ArtRdm);
+	struct TArtRdm *pArtRdm = &(m_ArtNetPacket.pArtPacket->ArtRdm);
 	const uint16_t portAddress = static_cast<uint16_t>((pArtRdm->Net << 8)) | static_cast<uint16_t>((pArtRdm->Address));
 
 	for (uint32_t i = 0; i < ArtNet::MAX_PORTS; i++) {
@@ -38,7 +38,7 @@
 void ArtNetNode::HandleTimeSync() {
 	DEBUG_ENTRY
 
-	struct TArtTimeSync *pArtTimeSync = &(m_ArtNetPacket.ArtPacket.ArtTimeSync);
+	struct TArtTimeSync *pArtTimeSync = &(m_ArtNetPacket.pArtPacket->ArtTimeSync);
 
 	m_pArtNetTimeSync->Handler(reinterpret_cast<const struct TArtNetTimeSync*>(&pArtTimeSync->tm_sec));
 
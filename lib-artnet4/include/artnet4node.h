@@ -46,6 +46,7 @@ public:
 	void Start();
 	void Stop();
 	void Run();
+	uint32_t GetTimeoutMillis();
 
 	void HandleAddress(uint8_t nCommand) override;
 	uint8_t GetStatus(uint8_t nPortId) override;
@@ -26,6 +26,7 @@
  * THE SOFTWARE.
  */
 
+#include <algorithm>
 #include <stdint.h>
 #include <string.h>
 #include <stdio.h>
@@ -134,6 +135,16 @@ void ArtNet4Node::Run() {
 	}
 }
 
+uint32_t ArtNet4Node::GetTimeoutMillis() {
+	const uint32_t nTimeoutMillis = ArtNetNode::GetTimeoutMillis();
+
+	if (m_Bridge.GetActiveOutputPorts() != 0) {
+		return std::min(nTimeoutMillis, m_Bridge.GetTimeoutMillis());
+	}
+
+	return nTimeoutMillis;
+}
+
 void ArtNet4Node::HandleAddress(uint8_t nCommand) {
 	DEBUG_ENTRY
 	DEBUG_PRINTF("m_nPages=%d", GetPages());
@@ -30,7 +30,7 @@
 #include <stdint.h>
 
 enum {
-	E131_MAX_PORTS = 32
+	E131_MAX_PORTS = 64
 };
 
 enum TE131PortDir {
@@ -85,6 +85,14 @@ enum TVectorDMP {
 
 #define VECTOR_UNIVERSE_DISCOVERY_UNIVERSE_LIST 0x00000001
 
+/**
+ * The DMX512-A START Code is the first property value
+ */
+enum TStartCode {
+	E131_START_CODE_DMX			= 0x00,	///< Null START Code, level data
+	E131_START_CODE_PRIORITY	= 0xDD	///< Per-address priority, 0 = the slot is not provided by the source
+};
+
 /**
  * When multicast addressing is used, the UDP destination Port shall be set to the standard ACN-SDT
  * multicast port (5568).
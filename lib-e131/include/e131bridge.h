@@ -33,6 +33,8 @@
 #include "e131packets.h"
 
 #include "lightset.h"
+#include "lightsetframe.h"
+#include "lightsetmergepool.h"
 
 // Handlers
 #include "e131dmx.h"
@@ -42,6 +44,22 @@ enum {
 	E131_MAX_UARTS = 4
 };
 
+enum {
+	E131_MERGE_SOURCES_MAX = 4,		///< Sources per universe, more sources are discarded
+	E131_MERGE_BUFFERS_DEFAULT = 8
+};
+
+enum {
+	E131_DRAIN_PACKETS_DEFAULT = 8,		///< Packets handled in one Run
+	E131_DRAIN_MICROS_DEFAULT = 1000,	///< Time for handling the packets in one Run
+	E131_QUEUE_DEPTH = 32				///< Datagrams queued between two Run
+};
+
+enum {
+	E131_UNIVERSE_INDEX_SIZE = 512,	///< Power of 2, holds the output universes and the synchronization addresses
+	E131_PORT_NONE = 0xFF
+};
+
 #define UUID_STRING_LENGTH	36
 
 struct TE131BridgeState {
@@ -57,32 +75,42 @@ struct TE131BridgeState {
 	uint32_t SynchronizationTime;
 	uint32_t DiscoveryTime;
 	uint16_t DiscoveryPacketLength;
-	uint16_t nSynchronizationAddressSourceA;
-	uint16_t nSynchronizationAddressSourceB;
 	uint8_t nActiveInputPorts;
 	uint8_t nActiveOutputPorts;
-	uint8_t nPriority;
+};
+
+struct TE131BridgeRunStats {
+	uint32_t nPackets;							///< Packets received
+	uint32_t nBurstMax;							///< Most packets handled in one Run
+	uint32_t nBurstLimited;						///< Run returned at the packet or time limit, more packets may be waiting
 };
 
 struct TSource {
-	uint32_t time;
-	uint32_t ip;
-	uint8_t data[E131_DMX_LENGTH];
-	uint8_t cid[E131_CID_LENGTH];
-	uint8_t sequenceNumberData;
+	uint8_t *pData;								///< The data received, a pool buffer only while merging
+	uint8_t *pPriority;							///< Per-address priorities (START Code 0xDD), a pool buffer
+	uint32_t nMillis;							///< The latest time of the data received
+	uint32_t nPriorityMillis;					///< The latest time of the per-address priorities received
+	uint32_t aCid[E131_CID_LENGTH / 4];			///< Sender's CID, compared word wise
+	uint32_t nCidHash;							///< The CID words folded, compared first
+	uint16_t nLength;							///< Length of the data received
+	uint16_t nSynchronizationAddress;			///< 0 = not synchronized
+	uint8_t nSequenceNumber;
 };
 
 struct TE131OutputPort {
 	uint8_t data[E131_DMX_LENGTH];
 	uint16_t length;
+	struct TLightSetDirty tDirty;	///< Slots changed since the last LightSet::SetDataRange
 	uint16_t nUniverse;
 	E131Merge mergeMode;
 	bool IsDataPending;
 	bool bIsEnabled;
 	bool IsTransmitting;
 	bool IsMerging;
-	struct TSource sourceA;
-	struct TSource sourceB;
+	uint8_t nPriority;							///< Priority of the sources in the table
+	uint8_t nSources;							///< Number of sources, merging when > 1
+	uint8_t nNextPort;							///< Next output port with the same universe
+	struct TSource aSources[E131_MERGE_SOURCES_MAX];
 };
 
 struct TE131InputPort {
@@ -94,6 +122,22 @@ struct TE131InputPort {
 	uint32_t nMulticastIp;
 };
 
+/**
+ * Universe index, open addressing on the universe number.
+ * An entry exists, and its multicast group is joined, while an output port
+ * or a source synchronization address uses the universe.
+ */
+struct TE131UniverseIndex {
+	uint16_t nUniverse;							///< 0 = free
+	uint16_t nSynchronizationRefs;				///< Number of sources with the universe as synchronization address
+	uint8_t nPort;								///< First output port, E131_PORT_NONE = none
+};
+
+static_assert(E131_MAX_PORTS <= LightSetFrame::MAX_PORTS, "LightSetFrame port mask is too small");
+static_assert(E131_MAX_PORTS < 0xFF, "A port index is an uint8_t, 0xFF is E131_PORT_NONE");
+static_assert((E131_UNIVERSE_INDEX_SIZE & (E131_UNIVERSE_INDEX_SIZE - 1)) == 0, "E131_UNIVERSE_INDEX_SIZE is not a power of 2");
+static_assert(E131_UNIVERSE_INDEX_SIZE > (E131_MAX_PORTS * (1 + E131_MERGE_SOURCES_MAX)), "E131_UNIVERSE_INDEX_SIZE is too small");
+
 class E131Bridge {
 public:
 	E131Bridge();
@@ -101,6 +145,18 @@ public:
 
 	void SetOutput(LightSet *pLightSet) {
 		m_pLightSet = pLightSet;
+		m_LightSetFrame.SetLightSet(pLightSet);
+	}
+
+	/**
+	 * Maximum time between the first and the last universe of a frame,
+	 * the frame is committed to the output when it expires.
+	 */
+	void SetFrameDeadline(uint32_t nDeadlineMillis) {
+		m_LightSetFrame.SetDeadline(nDeadlineMillis);
+	}
+	uint32_t GetFrameDeadline() const {
+		return m_LightSetFrame.GetDeadline();
 	}
 
 	const uint8_t *GetSoftwareVersion();
@@ -119,6 +175,29 @@ public:
 		return m_State.nActiveInputPorts;
 	}
 
+	/**
+	 * Source buffers shared by the merging universes, set before Start
+	 */
+	void SetMergeBuffers(uint32_t nMergeBuffers) {
+		m_nMergeBuffers = nMergeBuffers;
+	}
+	uint32_t GetMergeBuffers() const {
+		return m_nMergeBuffers;
+	}
+
+	/**
+	 * Run handles up to nPackets received, as long as it is within nMicros,
+	 * so a burst is absorbed without starving the main loop.
+	 */
+	void SetDrain(uint32_t nPackets, uint32_t nMicros) {
+		m_nDrainPackets = (nPackets == 0) ? 1 : nPackets;
+		m_nDrainMicros = nMicros;
+	}
+
+	const struct TE131BridgeRunStats& GetRunStats() const {
+		return m_RunStats;
+	}
+
 	void SetDirectUpdate(bool bDirectUpdate) {
 		m_bDirectUpdate = bDirectUpdate;
 	}
@@ -192,6 +271,11 @@ public:
 	void Stop();
 
 	void Run();
+	/**
+	 * Milliseconds until Run() has timed work to do, UINT32_MAX when it only reacts on received packets.
+	 * For an event-driven main loop, waiting for a readable handle.
+	 */
+	uint32_t GetTimeoutMillis() const;
 
 	void Print();
 
@@ -199,21 +283,36 @@ private:
 	bool IsValidRoot();
 	bool IsValidDataPacket();
 
-	void SetNetworkDataLossCondition(bool bSourceA = true, bool bSourceB = true);
+	void SetNetworkDataLossCondition();
+	void SetNetworkDataLossCondition(uint32_t nPortIndex);
 
-	void SetSynchronizationAddress(bool bSourceA, bool bSourceB, uint16_t nSynchronizationAddress);
+	void SetSynchronizationAddress(uint32_t nPortIndex, uint32_t nSource, uint16_t nSynchronizationAddress);
+	bool IsSynchronizationAddress(uint16_t nSynchronizationAddress) const;
+	void LeaveSynchronizationAddress(uint16_t nSynchronizationAddress);
 
+	int32_t GetSource(uint32_t nPortIndex, const uint32_t *pCid, uint32_t nCidHash) const;
+	int32_t AddSource(uint32_t nPortIndex, const uint32_t *pCid, uint32_t nCidHash);
+	void RemoveSource(uint32_t nPortIndex, uint32_t nSource);
+	void RemoveSources(uint32_t nPortIndex);
 	void CheckMergeTimeouts(uint8_t nPortIndex);
+	void UpdateMergeMode();
 	bool IsPriorityTimeOut(uint8_t nPortIndex);
-	bool isIpCidMatch(const struct TSource *);
 	bool IsDmxDataChanged(uint8_t nPortIndex, const uint8_t *pData, uint16_t nLength);
 	bool IsMergedDmxDataChanged(uint8_t nPortIndex, const uint8_t *pData, uint16_t nLength);
 
+	void HandlePacket();
 	void HandleDmx();
+	void HandlePriority();
 	void HandleSynchronization();
 
 	uint32_t UniverseToMulticastIp(uint16_t nUniverse) const;
-	void LeaveUniverse(uint8_t nPortIndex, uint16_t nUniverse);
+
+	int32_t FindUniverse(uint16_t nUniverse) const;
+	uint32_t AddUniverse(uint16_t nUniverse);
+	void ReleaseUniverse(uint32_t nIndex);
+	void LinkPort(uint8_t nPortIndex, uint16_t nUniverse);
+	void UnlinkPort(uint8_t nPortIndex);
+	void UpdateFramePortMask();
 
 	// Input
 	void HandleDmxIn();
@@ -225,6 +324,7 @@ private:
 	int32_t m_nHandle;
 
 	LightSet *m_pLightSet;
+	LightSetFrame m_LightSetFrame;
 
 	bool m_bDirectUpdate;
 	bool m_bEnableDataIndicator;
@@ -234,9 +334,18 @@ private:
 
 	struct TE131BridgeState m_State;
 	struct TE131OutputPort m_OutputPort[E131_MAX_PORTS];
+	struct TE131UniverseIndex m_UniverseIndex[E131_UNIVERSE_INDEX_SIZE];
 	struct TE131InputPort m_InputPort[E131_MAX_UARTS];
 	struct TE131 m_E131;
 
+	LightSetMergePool m_MergePool;
+	uint32_t m_nMergeBuffers;
+
+	uint32_t m_nDrainPackets;
+	uint32_t m_nDrainMicros;
+	struct TE131BridgeRunStats m_RunStats;
+	uint8_t m_UniversePriority[E131_DMX_LENGTH];	///< Per-address priorities for a source without them
+
 	// Input
 	E131Dmx *m_pE131DmxIn;
 	TE131DataPacket *m_pE131DataPacket;
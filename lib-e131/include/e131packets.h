@@ -156,13 +156,13 @@ union UE131Packet {
 };
 
 /**
- *
+ * A received packet, parsed in place in the receive buffer of the network
  */
 struct TE131 {
 	int length;						///<
 	uint32_t IPAddressFrom;			///<
 	uint32_t IPAddressTo;			///<
-	union UE131Packet E131Packet;	///<
+	union UE131Packet *pE131Packet;	///<
 };
 
 #define ROOT_LAYER_SIZE						sizeof(struct TRootLayer)
@@ -37,6 +37,7 @@
 #include "e117const.h"
 
 #include "lightset.h"
+#include "lightsetdata.h"
 
 #include "hardware.h"
 #include "network.h"
@@ -55,6 +56,9 @@ E131Bridge::E131Bridge() :
 	m_bEnableDataIndicator(true),
 	m_nCurrentPacketMillis(0),
 	m_nPreviousPacketMillis(0),
+	m_nMergeBuffers(E131_MERGE_BUFFERS_DEFAULT),
+	m_nDrainPackets(E131_DRAIN_PACKETS_DEFAULT),
+	m_nDrainMicros(E131_DRAIN_MICROS_DEFAULT),
 	m_pE131DmxIn(nullptr),
 	m_pE131DataPacket(nullptr),
 	m_pE131DiscoveryPacket(nullptr),
@@ -72,6 +76,13 @@ E131Bridge::E131Bridge() :
 		memset(&m_OutputPort[i], 0, sizeof(struct TE131OutputPort));
 		m_OutputPort[i].nUniverse = E131_UNIVERSE_DEFAULT;
 		m_OutputPort[i].mergeMode = E131Merge::HTP;
+		m_OutputPort[i].nPriority = E131_PRIORITY_LOWEST;
+	}
+
+	for (uint32_t i = 0; i < E131_UNIVERSE_INDEX_SIZE; i++) {
+		m_UniverseIndex[i].nUniverse = 0;
+		m_UniverseIndex[i].nSynchronizationRefs = 0;
+		m_UniverseIndex[i].nPort = E131_PORT_NONE;
 	}
 
 	for (uint32_t i = 0; i < E131_MAX_UARTS; i++) {
@@ -80,7 +91,7 @@ E131Bridge::E131Bridge() :
 	}
 
 	memset(&m_State, 0, sizeof(struct TE131BridgeState));
-	m_State.nPriority = E131_PRIORITY_LOWEST;
+	memset(&m_RunStats, 0, sizeof(struct TE131BridgeRunStats));
 
 	char aSourceName[E131_SOURCE_NAME_LENGTH];
 	uint8_t nLength;
@@ -90,6 +101,8 @@ E131Bridge::E131Bridge() :
 	m_nHandle = Network::Get()->Begin(E131_DEFAULT_PORT); 	// This must be here (and not in Start) for Mac OS and Linux
 	assert(m_nHandle != -1);								// ToDO Rewrite SetUniverse
 
+	Network::Get()->SetQueueDepth(m_nHandle, E131_QUEUE_DEPTH);
+
 	E131Uuid e131UUID;
 	e131UUID.GetHardwareUuid(m_Cid);
 }
@@ -99,6 +112,8 @@ E131Bridge::~E131Bridge() {
 }
 
 void E131Bridge::Start() {
+	m_MergePool.Setup(m_nMergeBuffers);
+
 	if (m_pE131DmxIn != nullptr) {
 		if (m_pE131DataPacket == nullptr) {
 			struct in_addr addr;
@@ -134,6 +149,10 @@ void E131Bridge::Stop() {
 		}
 	}
 
+	for (uint32_t i = 0; i < E131_MAX_PORTS; i++) {
+		RemoveSources(i);
+	}
+
 	if (m_pE131DmxIn != nullptr) {
 		for (uint32_t nPortIndex = 0; nPortIndex < E131_MAX_UARTS; nPortIndex++) {
 			if (m_InputPort[nPortIndex].bIsEnabled) {
@@ -174,61 +193,121 @@ uint32_t E131Bridge::UniverseToMulticastIp(uint16_t nUniverse) const {
 	return nMulticastIp;
 }
 
-void E131Bridge::SetSynchronizationAddress(bool bSourceA, bool bSourceB, uint16_t nSynchronizationAddress) {
-	DEBUG_ENTRY
-	DEBUG_PRINTF("bSourceA=%d, bSourceB=%d, nSynchronizationAddress=%d", bSourceA, bSourceB, nSynchronizationAddress);
+int32_t E131Bridge::FindUniverse(uint16_t nUniverse) const {
+	assert(nUniverse != 0);
 
-	assert(nSynchronizationAddress != 0);
+	for (uint32_t i = nUniverse & (E131_UNIVERSE_INDEX_SIZE - 1);; i = (i + 1) & (E131_UNIVERSE_INDEX_SIZE - 1)) {
+		if (m_UniverseIndex[i].nUniverse == nUniverse) {
+			return static_cast<int32_t>(i);
+		}
+		if (m_UniverseIndex[i].nUniverse == 0) {
+			return -1;
+		}
+	}
+}
 
-	uint16_t *pSynchronizationAddressSource;
+/**
+ * Returns the index of the universe, a new universe joins its multicast group
+ */
+uint32_t E131Bridge::AddUniverse(uint16_t nUniverse) {
+	assert(nUniverse != 0);
 
-	if (bSourceA) {
-		pSynchronizationAddressSource = &m_State.nSynchronizationAddressSourceA;
-	} else if (bSourceB) {
-		pSynchronizationAddressSource = &m_State.nSynchronizationAddressSourceB;
-	} else {
-		DEBUG_EXIT
-		return; // Just make the compiler happy
-	}
-
-	if (*pSynchronizationAddressSource == 0) {
-		*pSynchronizationAddressSource = nSynchronizationAddress;
-		DEBUG_PUTS("SynchronizationAddressSource == 0");
-	} else if (*pSynchronizationAddressSource != nSynchronizationAddress) {
-		// E131_MAX_PORTS forces to check all ports
-		LeaveUniverse(E131_MAX_PORTS, *pSynchronizationAddressSource);
-		*pSynchronizationAddressSource = nSynchronizationAddress;
-		DEBUG_PUTS("SynchronizationAddressSource != nSynchronizationAddress");
-	} else {
-		DEBUG_PUTS("Already received SynchronizationAddress");
-		DEBUG_EXIT
-		return;
+	uint32_t i = nUniverse & (E131_UNIVERSE_INDEX_SIZE - 1);
+
+	while (m_UniverseIndex[i].nUniverse != 0) {
+		if (m_UniverseIndex[i].nUniverse == nUniverse) {
+			return i;
+		}
+		i = (i + 1) & (E131_UNIVERSE_INDEX_SIZE - 1);
 	}
 
-	Network::Get()->JoinGroup(m_nHandle, UniverseToMulticastIp(nSynchronizationAddress));
+	DEBUG_PRINTF("nUniverse=%d, i=%d", nUniverse, static_cast<int>(i));
 
-	DEBUG_EXIT
+	m_UniverseIndex[i].nUniverse = nUniverse;
+	m_UniverseIndex[i].nSynchronizationRefs = 0;
+	m_UniverseIndex[i].nPort = E131_PORT_NONE;
+
+	Network::Get()->JoinGroup(m_nHandle, UniverseToMulticastIp(nUniverse));
+
+	return i;
 }
 
-void E131Bridge::LeaveUniverse(uint8_t nPortIndex, uint16_t nUniverse) {
-	DEBUG_ENTRY
-	DEBUG_PRINTF("nPortIndex=%d, nUniverse=%d", nPortIndex, nUniverse);
+/**
+ * An unused universe leaves its multicast group and is removed from the index.
+ * The entries after it are shifted back, so a lookup never passes a free entry.
+ */
+void E131Bridge::ReleaseUniverse(uint32_t nIndex) {
+	assert(nIndex < E131_UNIVERSE_INDEX_SIZE);
+	assert(m_UniverseIndex[nIndex].nUniverse != 0);
 
-	for (uint32_t i = 0; i < E131_MAX_PORTS; i++) {
-		DEBUG_PRINTF("\tnm_OutputPort[%d].nUniverse=%d", i, m_OutputPort[i].nUniverse);
+	if ((m_UniverseIndex[nIndex].nPort != E131_PORT_NONE) || (m_UniverseIndex[nIndex].nSynchronizationRefs != 0)) {
+		return;
+	}
 
-		if (i == nPortIndex) {
-			continue;
+	DEBUG_PRINTF("nUniverse=%d", m_UniverseIndex[nIndex].nUniverse);
+
+	Network::Get()->LeaveGroup(m_nHandle, UniverseToMulticastIp(m_UniverseIndex[nIndex].nUniverse));
+
+	uint32_t i = nIndex;
+	uint32_t j = nIndex;
+
+	for (;;) {
+		j = (j + 1) & (E131_UNIVERSE_INDEX_SIZE - 1);
+
+		if (m_UniverseIndex[j].nUniverse == 0) {
+			break;
 		}
-		if (m_OutputPort[i].nUniverse == nUniverse) {
-			DEBUG_EXIT
-			return;
+
+		// The entry stays when its home position is cyclically in (i, j]
+		const uint32_t k = m_UniverseIndex[j].nUniverse & (E131_UNIVERSE_INDEX_SIZE - 1);
+
+		if ((i <= j) ? ((i < k) && (k <= j)) : ((i < k) || (k <= j))) {
+			continue;
 		}
+
+		m_UniverseIndex[i] = m_UniverseIndex[j];
+		i = j;
 	}
 
-	Network::Get()->LeaveGroup(m_nHandle, UniverseToMulticastIp(nUniverse));
+	m_UniverseIndex[i].nUniverse = 0;
+	m_UniverseIndex[i].nSynchronizationRefs = 0;
+	m_UniverseIndex[i].nPort = E131_PORT_NONE;
+}
 
-	DEBUG_EXIT
+/**
+ * The ports of a universe are linked in ascending order
+ */
+void E131Bridge::LinkPort(uint8_t nPortIndex, uint16_t nUniverse) {
+	assert(nPortIndex < E131_MAX_PORTS);
+
+	struct TE131UniverseIndex &universe = m_UniverseIndex[AddUniverse(nUniverse)];
+	uint8_t *pNext = &universe.nPort;
+
+	while ((*pNext != E131_PORT_NONE) && (*pNext < nPortIndex)) {
+		pNext = &m_OutputPort[*pNext].nNextPort;
+	}
+
+	m_OutputPort[nPortIndex].nNextPort = *pNext;
+	*pNext = nPortIndex;
+}
+
+void E131Bridge::UnlinkPort(uint8_t nPortIndex) {
+	assert(nPortIndex < E131_MAX_PORTS);
+
+	const int32_t nIndex = FindUniverse(m_OutputPort[nPortIndex].nUniverse);
+	assert(nIndex >= 0);
+
+	uint8_t *pNext = &m_UniverseIndex[nIndex].nPort;
+
+	while (*pNext != nPortIndex) {
+		assert(*pNext != E131_PORT_NONE);
+		pNext = &m_OutputPort[*pNext].nNextPort;
+	}
+
+	*pNext = m_OutputPort[nPortIndex].nNextPort;
+	m_OutputPort[nPortIndex].nNextPort = E131_PORT_NONE;
+
+	ReleaseUniverse(static_cast<uint32_t>(nIndex));
 }
 
 void E131Bridge::SetUniverse(uint8_t nPortIndex, TE131PortDir dir, uint16_t nUniverse) {
@@ -258,7 +337,8 @@ void E131Bridge::SetUniverse(uint8_t nPortIndex, TE131PortDir dir, uint16_t nUni
 			if (m_OutputPort[nPortIndex].bIsEnabled) {
 				m_OutputPort[nPortIndex].bIsEnabled = false;
 				m_State.nActiveOutputPorts = m_State.nActiveOutputPorts - 1;
-				LeaveUniverse(nPortIndex, nUniverse);
+				UnlinkPort(nPortIndex);
+				UpdateFramePortMask();
 			}
 		}
 
@@ -277,18 +357,31 @@ void E131Bridge::SetUniverse(uint8_t nPortIndex, TE131PortDir dir, uint16_t nUni
 	if (m_OutputPort[nPortIndex].bIsEnabled) {
 		if (m_OutputPort[nPortIndex].nUniverse == nUniverse) {
 			return;
-		} else {
-			LeaveUniverse(nPortIndex, nUniverse);
 		}
+
+		UnlinkPort(nPortIndex);
 	} else {
 		m_State.nActiveOutputPorts = m_State.nActiveOutputPorts + 1;
 		assert(m_State.nActiveOutputPorts <= E131_MAX_PORTS);
 		m_OutputPort[nPortIndex].bIsEnabled = true;
+		UpdateFramePortMask();
 	}
 
-	Network::Get()->JoinGroup(m_nHandle, UniverseToMulticastIp(nUniverse));
-
 	m_OutputPort[nPortIndex].nUniverse = nUniverse;
+
+	LinkPort(nPortIndex, nUniverse);
+}
+
+void E131Bridge::UpdateFramePortMask() {
+	uint64_t nPortMask = 0;
+
+	for (uint32_t i = 0; i < E131_MAX_PORTS; i++) {
+		if (m_OutputPort[i].bIsEnabled) {
+			nPortMask |= (static_cast<uint64_t>(1) << i);
+		}
+	}
+
+	m_LightSetFrame.SetPortMask(nPortMask);
 }
 
 bool E131Bridge::GetUniverse(uint8_t nPortIndex, uint16_t &nUniverse, TE131PortDir tDir) const {
@@ -321,183 +414,50 @@ E131Merge E131Bridge::GetMergeMode(uint8_t nPortIndex) const {
 	return m_OutputPort[nPortIndex].mergeMode;
 }
 
-bool E131Bridge::IsDmxDataChanged(uint8_t nPortIndex, const uint8_t *pData, uint16_t nLength) {
-	assert(nPortIndex < E131_MAX_PORTS);
-	assert(pData != nullptr);
-
-	bool isChanged = false;
-
-	const uint8_t *pSrc = pData;
-	uint8_t *pDst = m_OutputPort[nPortIndex].data;
-
-	if (nLength != m_OutputPort[nPortIndex].length) {
-		m_OutputPort[nPortIndex].length = nLength;
-		for (unsigned i = 0 ; i < E131_DMX_LENGTH; i++) {
-			*pDst++ = *pSrc++;
-		}
-		return true;
-	}
-
-	for (unsigned i = 0; i < E131_DMX_LENGTH; i++) {
-		if (*pDst != *pSrc) {
-			*pDst = *pSrc;
-			isChanged = true;
-		}
-		pDst++;
-		pSrc++;
+void E131Bridge::HandleDmx() {
+	if (m_E131.pE131Packet->Data.DMPLayer.PropertyValues[0] == E131_START_CODE_PRIORITY) {
+		HandlePriority();
+		return;
 	}
 
-	return isChanged;
-}
+	const uint8_t *p = &m_E131.pE131Packet->Data.DMPLayer.PropertyValues[1];
+	const uint16_t slots = __builtin_bswap16(m_E131.pE131Packet->Data.DMPLayer.PropertyValueCount) - 1;
+	const uint8_t nPriority = m_E131.pE131Packet->Data.FrameLayer.Priority;
+	const uint8_t nSequenceNumber = m_E131.pE131Packet->Data.FrameLayer.SequenceNumber;
 
-bool E131Bridge::IsMergedDmxDataChanged(uint8_t nPortIndex, const uint8_t *pData, uint16_t nLength) {
-	assert(nPortIndex < E131_MAX_PORTS);
-	assert(pData != nullptr);
+	uint32_t aCid[E131_CID_LENGTH / 4];
+	memcpy(aCid, m_E131.pE131Packet->Data.RootLayer.Cid, E131_CID_LENGTH);
+	const uint32_t nCidHash = aCid[0] ^ aCid[1] ^ aCid[2] ^ aCid[3];
 
-	bool isChanged = false;
+	// Frame layer
+	// 8.2 Association of Multicast Addresses and Universe
+	// Note: The identity of the universe shall be determined by the universe number in the
+	// packet and not assumed from the multicast address.
+	const int32_t nIndex = FindUniverse(__builtin_bswap16(m_E131.pE131Packet->Data.FrameLayer.Universe));
 
-	if (!m_State.IsMergeMode) {
-		m_State.IsMergeMode = true;
-		m_State.IsChanged = true;
+	if (nIndex < 0) {
+		return;
 	}
 
-	m_OutputPort[nPortIndex].IsMerging = true;
+	for (uint32_t i = m_UniverseIndex[nIndex].nPort; i != E131_PORT_NONE; i = m_OutputPort[i].nNextPort) {
+		struct TE131OutputPort &port = m_OutputPort[i];
 
-	if (m_OutputPort[nPortIndex].mergeMode == E131Merge::HTP) {
-
-		if (nLength != m_OutputPort[nPortIndex].length) {
-			m_OutputPort[nPortIndex].length = nLength;
-			for (unsigned i = 0; i < nLength; i++) {
-				uint8_t data = std::max(m_OutputPort[nPortIndex].sourceA.data[i], m_OutputPort[nPortIndex].sourceB.data[i]);
-				m_OutputPort[nPortIndex].data[i] = data;
-			}
-			return true;
-		}
-
-		for (unsigned i = 0; i < nLength; i++) {
-			uint8_t data = std::max(m_OutputPort[nPortIndex].sourceA.data[i], m_OutputPort[nPortIndex].sourceB.data[i]);
-			if (data != m_OutputPort[nPortIndex].data[i]) {
-				m_OutputPort[nPortIndex].data[i] = data;
-				isChanged = true;
+		if (port.nSources > 1) {
+			if (__builtin_expect((!m_State.bDisableMergeTimeout), 1)) {
+				CheckMergeTimeouts(i);
 			}
 		}
 
-		return isChanged;
-	} else {
-		return IsDmxDataChanged(nPortIndex, pData, nLength);
-	}
-}
-
-void E131Bridge::CheckMergeTimeouts(uint8_t nPortIndex) {
-	assert(nPortIndex < E131_MAX_PORTS);
-
-	const uint32_t timeOutA = m_nCurrentPacketMillis - m_OutputPort[nPortIndex].sourceA.time;
-
-	if (timeOutA > (E131_MERGE_TIMEOUT_SECONDS * 1000)) {
-		m_OutputPort[nPortIndex].sourceA.ip = 0;
-		memset(m_OutputPort[nPortIndex].sourceA.cid, 0, E131_CID_LENGTH);
-		m_OutputPort[nPortIndex].IsMerging = false;
-	}
-
-	const uint32_t timeOutB = m_nCurrentPacketMillis - m_OutputPort[nPortIndex].sourceB.time;
-
-	if (timeOutB > (E131_MERGE_TIMEOUT_SECONDS * 1000)) {
-		m_OutputPort[nPortIndex].sourceB.ip = 0;
-		memset(m_OutputPort[nPortIndex].sourceB.cid, 0, E131_CID_LENGTH);
-		m_OutputPort[nPortIndex].IsMerging = false;
-	}
-
-	bool bIsMerging = false;
-
-	for (uint32_t i = 0; i < E131_MAX_PORTS; i++) {
-		bIsMerging |= m_OutputPort[i].IsMerging;
-	}
-
-	if (!bIsMerging) {
-		m_State.IsChanged = true;
-		m_State.IsMergeMode = false;
-	}
-
-}
-
-bool E131Bridge::IsPriorityTimeOut(uint8_t nPortIndex) {
-	assert(nPortIndex < E131_MAX_PORTS);
-
-	const uint32_t timeOutA = m_nCurrentPacketMillis - m_OutputPort[nPortIndex].sourceA.time;
-	const uint32_t timeOutB = m_nCurrentPacketMillis - m_OutputPort[nPortIndex].sourceB.time;
-
-	if ( (m_OutputPort[nPortIndex].sourceA.ip != 0) && (m_OutputPort[nPortIndex].sourceB.ip != 0) ) {
-		if ( (timeOutA < (E131_PRIORITY_TIMEOUT_SECONDS * 1000)) || (timeOutB < (E131_PRIORITY_TIMEOUT_SECONDS * 1000)) ) {
-			return false;
-		} else {
-			return true;
-		}
-	} else if ( (m_OutputPort[nPortIndex].sourceA.ip != 0) && (m_OutputPort[nPortIndex].sourceB.ip == 0) ) {
-		if (timeOutA > (E131_PRIORITY_TIMEOUT_SECONDS * 1000)) {
-			return true;
-		}
-	} else if ( (m_OutputPort[nPortIndex].sourceA.ip == 0) && (m_OutputPort[nPortIndex].sourceB.ip != 0) ) {
-		if (timeOutB > (E131_PRIORITY_TIMEOUT_SECONDS * 1000)) {
-			return true;
-		}
-	}
-
-	return false;
-}
-
-bool E131Bridge::isIpCidMatch(const struct TSource *source) {
-	if (source->ip != m_E131.IPAddressFrom) {
-		return false;
-	}
-
-	if (memcmp(source->cid, m_E131.E131Packet.Raw.RootLayer.Cid, E131_CID_LENGTH) != 0) {
-		return false;
-	}
-
-	return true;
-}
-
-void E131Bridge::HandleDmx() {
-	const uint8_t *p = &m_E131.E131Packet.Data.DMPLayer.PropertyValues[1];
-	const uint16_t slots = __builtin_bswap16(m_E131.E131Packet.Data.DMPLayer.PropertyValueCount) - 1;
-
-	for (uint32_t i = 0; i < E131_MAX_PORTS; i++) {
-		if (!m_OutputPort[i].bIsEnabled) {
-			continue;
-		}
-
-		// Frame layer
-		// 8.2 Association of Multicast Addresses and Universe
-		// Note: The identity of the universe shall be determined by the universe number in the
-		// packet and not assumed from the multicast address.
-		if (m_E131.E131Packet.Data.FrameLayer.Universe != __builtin_bswap16(m_OutputPort[i].nUniverse)) {
-			continue;
-		}
-
-		struct TSource *pSourceA = &m_OutputPort[i].sourceA;
-		struct TSource *pSourceB = &m_OutputPort[i].sourceB;
-
-		const uint32_t ipA = pSourceA->ip;
-		const uint32_t ipB = pSourceB->ip;
-
-		const bool isSourceA = isIpCidMatch(pSourceA);
-		const bool isSourceB = isIpCidMatch(pSourceB);
-
-		bool sendNewData = false;
+		int32_t nSource = GetSource(i, aCid, nCidHash);
 
 		// 6.9.2 Sequence Numbering
 		// Having first received a packet with sequence number A, a second packet with sequence number B
 		// arrives. If, using signed 8-bit binary arithmetic, B – A is less than or equal to 0, but greater than -20 then
 		// the packet containing sequence number B shall be deemed out of sequence and discarded
-		if (isSourceA) {
-			const auto diff = static_cast<int8_t>(m_E131.E131Packet.Data.FrameLayer.SequenceNumber - pSourceA->sequenceNumberData);
-			pSourceA->sequenceNumberData = m_E131.E131Packet.Data.FrameLayer.SequenceNumber;
-			if ((diff <= 0) && (diff > -20)) {
-				continue;
-			}
-		} else if (isSourceB) {
-			const auto diff = static_cast<int8_t>(m_E131.E131Packet.Data.FrameLayer.SequenceNumber - pSourceB->sequenceNumberData);
-			pSourceB->sequenceNumberData = m_E131.E131Packet.Data.FrameLayer.SequenceNumber;
+		if (nSource >= 0) {
+			struct TSource &source = port.aSources[nSource];
+			const auto diff = static_cast<int8_t>(nSequenceNumber - source.nSequenceNumber);
+			source.nSequenceNumber = nSequenceNumber;
 			if ((diff <= 0) && (diff > -20)) {
 				continue;
 			}
@@ -505,106 +465,78 @@ void E131Bridge::HandleDmx() {
 
 		// This bit, when set to 1, indicates that the data in this packet is intended for use in visualization or media
 		// server preview applications and shall not be used to generate live output.
-		if ((m_E131.E131Packet.Data.FrameLayer.Options & E131_OPTIONS_MASK_PREVIEW_DATA) != 0) {
+		if ((m_E131.pE131Packet->Data.FrameLayer.Options & E131_OPTIONS_MASK_PREVIEW_DATA) != 0) {
 			continue;
 		}
 
 		// Upon receipt of a packet containing this bit set to a value of 1, receiver shall enter network data loss condition.
 		// Any property values in these packets shall be ignored.
-		if ((m_E131.E131Packet.Data.FrameLayer.Options & E131_OPTIONS_MASK_STREAM_TERMINATED) != 0) {
-			if (isSourceA || isSourceB) {
-				SetNetworkDataLossCondition(isSourceA, isSourceB);
+		if ((m_E131.pE131Packet->Data.FrameLayer.Options & E131_OPTIONS_MASK_STREAM_TERMINATED) != 0) {
+			if (nSource >= 0) {
+				RemoveSource(i, static_cast<uint32_t>(nSource));
+				UpdateMergeMode();
+				if (port.nSources == 0) {
+					SetNetworkDataLossCondition(i);
+				}
 			}
 			continue;
 		}
 
-		if (m_State.IsMergeMode) {
-			if (__builtin_expect((!m_State.bDisableMergeTimeout), 1)) {
-				CheckMergeTimeouts(i);
+		// 6.2.3 Priority, per universe
+		// The sources in the table all have the priority of the universe
+		if (port.nSources == 0) {
+			port.nPriority = nPriority;
+		} else if (nPriority > port.nPriority) {
+			RemoveSources(i);
+			UpdateMergeMode();
+			nSource = -1;
+			port.nPriority = nPriority;
+		} else if (nPriority < port.nPriority) {
+			if ((nSource >= 0) && (port.nSources > 1)) {
+				// This source is no longer part of the merge
+				RemoveSource(i, static_cast<uint32_t>(nSource));
+				UpdateMergeMode();
+				continue;
+			}
+			if ((nSource < 0) && !IsPriorityTimeOut(i)) {
+				continue;
+			}
+			if (nSource < 0) {
+				RemoveSources(i);
+				UpdateMergeMode();
 			}
+			port.nPriority = nPriority;
 		}
 
-		if (m_E131.E131Packet.Data.FrameLayer.Priority < m_State.nPriority ){
-			if (!IsPriorityTimeOut(i)) {
+		if (nSource < 0) {
+			nSource = AddSource(i, aCid, nCidHash);
+
+			if (nSource < 0) {
+				// The source table is full or there is no merge buffer available
 				continue;
 			}
-			m_State.nPriority = m_E131.E131Packet.Data.FrameLayer.Priority;
-		} else if (m_E131.E131Packet.Data.FrameLayer.Priority > m_State.nPriority) {
-			m_OutputPort[i].sourceA.ip = 0;
-			m_OutputPort[i].sourceB.ip = 0;
-			m_State.IsMergeMode = false;
-			m_State.nPriority = m_E131.E131Packet.Data.FrameLayer.Priority;
-		}
-
-		if ((ipA == 0) && (ipB == 0)) {
-			//printf("1. First package from Source\n");
-			pSourceA->ip = m_E131.IPAddressFrom;
-			pSourceA->sequenceNumberData = m_E131.E131Packet.Data.FrameLayer.SequenceNumber;
-			memcpy(pSourceA->cid, m_E131.E131Packet.Data.RootLayer.Cid, 16);
-			pSourceA->time = m_nCurrentPacketMillis;
-			memcpy(pSourceA->data, p, slots);
-			sendNewData = IsDmxDataChanged(i, p, slots);
 
-		} else if (isSourceA && (ipB == 0)) {
-			//printf("2. Continue package from SourceA\n");
-			pSourceA->sequenceNumberData = m_E131.E131Packet.Data.FrameLayer.SequenceNumber;
-			pSourceA->time = m_nCurrentPacketMillis;
-			memcpy(pSourceA->data, p, slots);
-			sendNewData = IsDmxDataChanged(i, p, slots);
+			port.aSources[nSource].nSequenceNumber = nSequenceNumber;
+		}
 
-		} else if ((ipA == 0) && isSourceB) {
-			//printf("3. Continue package from SourceB\n");
-			pSourceB->sequenceNumberData = m_E131.E131Packet.Data.FrameLayer.SequenceNumber;
-			pSourceB->time = m_nCurrentPacketMillis;
-			memcpy(pSourceB->data, p, slots);
-			sendNewData = IsDmxDataChanged(i, p, slots);
+		struct TSource &source = port.aSources[nSource];
 
-		} else if (!isSourceA && (ipB == 0)) {
-			//printf("4. New ip, start merging\n");
-			pSourceB->ip = m_E131.IPAddressFrom;
-			pSourceB->sequenceNumberData = m_E131.E131Packet.Data.FrameLayer.SequenceNumber;
-			memcpy(pSourceB->cid, m_E131.E131Packet.Data.RootLayer.Cid, 16);
-			pSourceB->time = m_nCurrentPacketMillis;
-			memcpy(pSourceB->data, p, slots);
-			sendNewData = IsMergedDmxDataChanged(i, pSourceB->data, slots);
-
-		} else if ((ipA == 0) && !isSourceB) {
-			//printf("5. New ip, start merging\n");
-			pSourceA->ip = m_E131.IPAddressFrom;
-			pSourceA->sequenceNumberData = m_E131.E131Packet.Data.FrameLayer.SequenceNumber;
-			memcpy(pSourceA->cid, m_E131.E131Packet.Data.RootLayer.Cid, 16);
-			pSourceA->time = m_nCurrentPacketMillis;
-			memcpy(pSourceA->data, p, slots);
-			sendNewData = IsMergedDmxDataChanged(i, pSourceA->data, slots);
-
-		} else if (isSourceA && !isSourceB) {
-			//printf("6. Continue merging\n");
-			pSourceA->sequenceNumberData = m_E131.E131Packet.Data.FrameLayer.SequenceNumber;
-			pSourceA->time = m_nCurrentPacketMillis;
-			memcpy(pSourceA->data, p, slots);
-			sendNewData = IsMergedDmxDataChanged(i, pSourceA->data, slots);
-
-		} else if (!isSourceA && isSourceB) {
-			//printf("7. Continue merging\n");
-			pSourceB->sequenceNumberData = m_E131.E131Packet.Data.FrameLayer.SequenceNumber;
-			pSourceB->time = m_nCurrentPacketMillis;
-			memcpy(pSourceB->data, p, slots);
-			sendNewData = IsMergedDmxDataChanged(i, pSourceB->data, slots);
-
-		} else if (isSourceA && isSourceB) {
-			printf("8. Source matches both buffers, this shouldn't be happening!\n");
-			assert(0);
-			return;
+		source.nMillis = m_nCurrentPacketMillis;
 
-		} else if (!isSourceA && !isSourceB) {
-			printf("9. More than two sources, discarding data\n");
-			assert(0);
-			return;
+		m_LightSetFrame.PortBegin(i, m_nCurrentPacketMillis);
 
+		bool sendNewData;
+
+		if (port.nSources == 1) {
+			sendNewData = IsDmxDataChanged(i, p, slots);
 		} else {
-			printf("0. No cases matched, this shouldn't happen!\n");
-			assert(0);
-			return;
+			assert(source.pData != nullptr);
+			memcpy(source.pData, p, slots);
+			if (slots < source.nLength) {
+				memset(&source.pData[slots], 0, static_cast<size_t>(source.nLength - slots));
+			}
+			source.nLength = slots;
+			sendNewData = IsMergedDmxDataChanged(i, source.pData, slots);
 		}
 
 		// This bit indicates whether to lock or revert to an unsynchronized state when synchronization is lost
@@ -613,18 +545,15 @@ void E131Bridge::HandleDmx() {
 		// new packets until synchronization resumes. When set to 1, once synchronization has been lost,
 		// components that had been operating in a synchronized state need not wait for a new
 		// E1.31 Synchronization Packet in order to update to the next E1.31 Data Packet.
-		if ((m_E131.E131Packet.Data.FrameLayer.Options & E131_OPTIONS_MASK_FORCE_SYNCHRONIZATION) == 0) {
+		if ((m_E131.pE131Packet->Data.FrameLayer.Options & E131_OPTIONS_MASK_FORCE_SYNCHRONIZATION) == 0) {
 			// 6.3.3.1 Synchronization Address Usage in an E1.31 Synchronization Packet
 			// An E1.31 Synchronization Packet is sent to synchronize the E1.31 data on a specific universe number.
 			// A Synchronization Address of 0 is thus meaningless, and shall not be transmitted.
 			// Receivers shall ignore E1.31 Synchronization Packets containing a Synchronization Address of 0.
-			if (m_E131.E131Packet.Data.FrameLayer.SynchronizationAddress != 0) {
+			if (m_E131.pE131Packet->Data.FrameLayer.SynchronizationAddress != 0) {
+				SetSynchronizationAddress(i, static_cast<uint32_t>(nSource), __builtin_bswap16(m_E131.pE131Packet->Data.FrameLayer.SynchronizationAddress));
+
 				if (!m_State.IsForcedSynchronized) {
-					if (!(isSourceA || isSourceB)) {
-						SetSynchronizationAddress((pSourceA->ip != 0), (pSourceB->ip != 0), __builtin_bswap16(m_E131.E131Packet.Data.FrameLayer.SynchronizationAddress));
-					} else {
-						SetSynchronizationAddress(isSourceA, isSourceB, __builtin_bswap16(m_E131.E131Packet.Data.FrameLayer.SynchronizationAddress));
-					}
 					m_State.IsForcedSynchronized = true;
 					m_State.IsSynchronized = true;
 				}
@@ -636,7 +565,8 @@ void E131Bridge::HandleDmx() {
 		if (sendNewData || m_bDirectUpdate) {
 			if ((!m_State.IsSynchronized) || (m_State.bDisableSynchronize)) {
 
-				m_pLightSet->SetData(i, m_OutputPort[i].data, m_OutputPort[i].length);
+				m_LightSetFrame.SetData(i, m_OutputPort[i].data, m_OutputPort[i].length, m_OutputPort[i].tDirty);
+				lightset::data::SetClean(m_OutputPort[i].tDirty);
 
 				if (!m_OutputPort[i].IsTransmitting) {
 					m_pLightSet->Start(i);
@@ -649,10 +579,67 @@ void E131Bridge::HandleDmx() {
 
 		}
 
+		m_LightSetFrame.PortEnd(i);
+
 		m_State.bIsReceivingDmx = true;
 	}
 }
 
+/**
+ * Per-address priorities (START Code 0xDD) are kept for the sources already in the table.
+ * They are used when the universe is merged, a single source is output as is.
+ */
+void E131Bridge::HandlePriority() {
+	const uint8_t *p = &m_E131.pE131Packet->Data.DMPLayer.PropertyValues[1];
+	const uint16_t slots = __builtin_bswap16(m_E131.pE131Packet->Data.DMPLayer.PropertyValueCount) - 1;
+	const uint8_t nSequenceNumber = m_E131.pE131Packet->Data.FrameLayer.SequenceNumber;
+
+	if ((slots > E131_DMX_LENGTH) || ((m_E131.pE131Packet->Data.FrameLayer.Options & (E131_OPTIONS_MASK_PREVIEW_DATA | E131_OPTIONS_MASK_STREAM_TERMINATED)) != 0)) {
+		return;
+	}
+
+	uint32_t aCid[E131_CID_LENGTH / 4];
+	memcpy(aCid, m_E131.pE131Packet->Data.RootLayer.Cid, E131_CID_LENGTH);
+	const uint32_t nCidHash = aCid[0] ^ aCid[1] ^ aCid[2] ^ aCid[3];
+
+	const int32_t nIndex = FindUniverse(__builtin_bswap16(m_E131.pE131Packet->Data.FrameLayer.Universe));
+
+	if (nIndex < 0) {
+		return;
+	}
+
+	for (uint32_t i = m_UniverseIndex[nIndex].nPort; i != E131_PORT_NONE; i = m_OutputPort[i].nNextPort) {
+		const int32_t nSource = GetSource(i, aCid, nCidHash);
+
+		if (nSource < 0) {
+			continue;
+		}
+
+		struct TSource &source = m_OutputPort[i].aSources[nSource];
+
+		// 6.9.2 Sequence Numbering, the sequence is shared by all START Codes of the source
+		const auto diff = static_cast<int8_t>(nSequenceNumber - source.nSequenceNumber);
+		source.nSequenceNumber = nSequenceNumber;
+		if ((diff <= 0) && (diff > -20)) {
+			continue;
+		}
+
+		if (source.pPriority == nullptr) {
+			source.pPriority = m_MergePool.Get();
+
+			if (source.pPriority == nullptr) {
+				continue;
+			}
+		}
+
+		// The slots not sent are not provided by the source
+		memcpy(source.pPriority, p, slots);
+		memset(&source.pPriority[slots], 0, static_cast<size_t>(E131_DMX_LENGTH - slots));
+
+		source.nPriorityMillis = m_nCurrentPacketMillis;
+	}
+}
+
 void E131Bridge::HandleSynchronization() {
 	// 6.3.3.1 Synchronization Address Usage in an E1.31 Synchronization Packet
 	// Receivers may ignore Synchronization Packets sent to multicast addresses
@@ -661,9 +648,9 @@ void E131Bridge::HandleSynchronization() {
 	// NOTE: There is no multicast addresses (To Ip) available
 	// We just check if SynchronizationAddress is published by a Source
 
-	const uint16_t nSynchronizationAddress = __builtin_bswap16(m_E131.E131Packet.Synchronization.FrameLayer.UniverseNumber);
+	const uint16_t nSynchronizationAddress = __builtin_bswap16(m_E131.pE131Packet->Synchronization.FrameLayer.UniverseNumber);
 
-	if ((nSynchronizationAddress != m_State.nSynchronizationAddressSourceA) && (nSynchronizationAddress != m_State.nSynchronizationAddressSourceB)) {
+	if (!IsSynchronizationAddress(nSynchronizationAddress)) {
 		LedBlink::Get()->SetMode(LEDBLINK_MODE_NORMAL);
 		DEBUG_PUTS("");
 		return;
@@ -674,7 +661,8 @@ void E131Bridge::HandleSynchronization() {
 	for (uint32_t i = 0; i < E131_MAX_PORTS; i++) {
 		if ((m_OutputPort[i].IsDataPending) || (m_OutputPort[i].bIsEnabled && m_bDirectUpdate)){
 
-			m_pLightSet->SetData(i, m_OutputPort[i].data, m_OutputPort[i].length);
+			m_LightSetFrame.SetData(i, m_OutputPort[i].data, m_OutputPort[i].length, m_OutputPort[i].tDirty);
+			lightset::data::SetClean(m_OutputPort[i].tDirty);
 
 			if (!m_OutputPort[i].IsTransmitting) {
 				m_pLightSet->Start(i);
@@ -685,62 +673,26 @@ void E131Bridge::HandleSynchronization() {
 		}
 	}
 
+	// The synchronization packet is the frame boundary
+	m_LightSetFrame.Commit();
+
 	if (m_pE131Sync != nullptr) {
 		m_pE131Sync->Handler();
 	}
 }
 
-void E131Bridge::SetNetworkDataLossCondition(bool bSourceA, bool bSourceB) {
+void E131Bridge::SetNetworkDataLossCondition() {
 	DEBUG_ENTRY
-	DEBUG_PRINTF("%d %d", bSourceA, bSourceB);
 
 	m_State.IsChanged = true;
+	m_State.IsNetworkDataLoss = true;
+	m_State.IsMergeMode = false;
+	m_State.IsSynchronized = false;
+	m_State.IsForcedSynchronized = false;
 
-	if (bSourceA && bSourceB) {
-		m_State.IsNetworkDataLoss = true;
-		m_State.IsMergeMode = false;
-		m_State.IsSynchronized = false;
-		m_State.IsForcedSynchronized = false;
-		m_State.nPriority = E131_PRIORITY_LOWEST;
-
-		for (uint32_t i = 0; i < E131_MAX_PORTS; i++) {
-			if (m_OutputPort[i].IsTransmitting) {
-				m_pLightSet->Stop(i);
-				m_OutputPort[i].sourceA.ip = 0;
-				memset(m_OutputPort[i].sourceA.cid, 0, E131_CID_LENGTH);
-				m_OutputPort[i].sourceB.ip = 0;
-				memset(m_OutputPort[i].sourceB.cid, 0, E131_CID_LENGTH);
-				m_OutputPort[i].length = 0;
-				m_OutputPort[i].IsDataPending = false;
-				m_OutputPort[i].IsTransmitting = false;
-				m_OutputPort[i].IsMerging = false;
-			}
-		}
-
-	} else {
-		for (uint32_t i = 0; i < E131_MAX_PORTS; i++) {
-			if (m_OutputPort[i].IsTransmitting) {
-
-				if ((bSourceA) && (m_OutputPort[i].sourceA.ip != 0)) {
-					m_OutputPort[i].sourceA.ip = 0;
-					memset(m_OutputPort[i].sourceA.cid, 0, E131_CID_LENGTH);
-					m_OutputPort[i].IsMerging = false;
-				}
-
-				if ((bSourceB) && (m_OutputPort[i].sourceB.ip != 0)) {
-					m_OutputPort[i].sourceB.ip = 0;
-					memset(m_OutputPort[i].sourceB.cid, 0, E131_CID_LENGTH);
-					m_OutputPort[i].IsMerging = false;
-				}
-
-				if (!m_State.IsMergeMode) {
-					m_pLightSet->Stop(i);
-					m_OutputPort[i].length = 0;
-					m_OutputPort[i].IsDataPending = false;
-					m_OutputPort[i].IsTransmitting = false;
-				}
-			}
-		}
+	for (uint32_t i = 0; i < E131_MAX_PORTS; i++) {
+		RemoveSources(i);
+		SetNetworkDataLossCondition(i);
 	}
 
 	LedBlink::Get()->SetMode(LEDBLINK_MODE_NORMAL);
@@ -749,6 +701,23 @@ void E131Bridge::SetNetworkDataLossCondition(bool bSourceA, bool bSourceB) {
 	DEBUG_EXIT
 }
 
+/**
+ * The universe has no sources left
+ */
+void E131Bridge::SetNetworkDataLossCondition(uint32_t nPortIndex) {
+	assert(nPortIndex < E131_MAX_PORTS);
+
+	struct TE131OutputPort &port = m_OutputPort[nPortIndex];
+
+	if (port.IsTransmitting) {
+		m_pLightSet->Stop(nPortIndex);
+		port.length = 0;
+		port.IsDataPending = false;
+		port.IsTransmitting = false;
+		m_State.IsChanged = true;
+	}
+}
+
 bool E131Bridge::IsTransmitting(uint8_t nPortIndex) const {
 	assert(nPortIndex < E131_MAX_PORTS);
 	return m_OutputPort[nPortIndex].IsTransmitting;
@@ -778,8 +747,11 @@ void E131Bridge::Clear(uint8_t nPortIndex) {
 	}
 
 	m_OutputPort[nPortIndex].length = E131_DMX_LENGTH;
+	lightset::data::SetAll(m_OutputPort[nPortIndex].tDirty, E131_DMX_LENGTH);
 
-	m_pLightSet->SetData(nPortIndex, m_OutputPort[nPortIndex].data, m_OutputPort[nPortIndex].length);
+	m_LightSetFrame.SetData(nPortIndex, m_OutputPort[nPortIndex].data, m_OutputPort[nPortIndex].length, m_OutputPort[nPortIndex].tDirty);
+	lightset::data::SetClean(m_OutputPort[nPortIndex].tDirty);
+	m_LightSetFrame.Commit();
 
 	if (m_OutputPort[nPortIndex].bIsEnabled && !m_OutputPort[nPortIndex].IsTransmitting) {
 		m_pLightSet->Start(nPortIndex);
@@ -792,12 +764,12 @@ void E131Bridge::Clear(uint8_t nPortIndex) {
 bool E131Bridge::IsValidRoot() {
 	// 5 E1.31 use of the ACN Root Layer Protocol
 	// Receivers shall discard the packet if the ACN Packet Identifier is not valid.
-	if (memcmp(m_E131.E131Packet.Raw.RootLayer.ACNPacketIdentifier, E117Const::ACN_PACKET_IDENTIFIER, E117_PACKET_IDENTIFIER_LENGTH) != 0) {
+	if (memcmp(m_E131.pE131Packet->Raw.RootLayer.ACNPacketIdentifier, E117Const::ACN_PACKET_IDENTIFIER, E117_PACKET_IDENTIFIER_LENGTH) != 0) {
 		return false;
 	}
 	
-	if (m_E131.E131Packet.Raw.RootLayer.Vector != __builtin_bswap32(E131_VECTOR_ROOT_DATA)
-			 && (m_E131.E131Packet.Raw.RootLayer.Vector != __builtin_bswap32(E131_VECTOR_ROOT_EXTENDED)) ) {
+	if (m_E131.pE131Packet->Raw.RootLayer.Vector != __builtin_bswap32(E131_VECTOR_ROOT_DATA)
+			 && (m_E131.pE131Packet->Raw.RootLayer.Vector != __builtin_bswap32(E131_VECTOR_ROOT_EXTENDED)) ) {
 		return false;
 	}
 
@@ -809,38 +781,71 @@ bool E131Bridge::IsValidDataPacket() {
 
 	// The DMP Layer's Vector shall be set to 0x02, which indicates a DMP Set Property message by
 	// transmitters. Receivers shall discard the packet if the received value is not 0x02.
-	if (m_E131.E131Packet.Data.DMPLayer.Vector != E131_VECTOR_DMP_SET_PROPERTY) {
+	if (m_E131.pE131Packet->Data.DMPLayer.Vector != E131_VECTOR_DMP_SET_PROPERTY) {
 		return false;
 	}
 
 	// Transmitters shall set the DMP Layer's Address Type and Data Type to 0xa1. Receivers shall discard the
 	// packet if the received value is not 0xa1.
-	if (m_E131.E131Packet.Data.DMPLayer.Type != 0xa1) {
+	if (m_E131.pE131Packet->Data.DMPLayer.Type != 0xa1) {
 		return false;
 	}
 
 	// Transmitters shall set the DMP Layer's First Property Address to 0x0000. Receivers shall discard the
 	// packet if the received value is not 0x0000.
-	if (m_E131.E131Packet.Data.DMPLayer.FirstAddressProperty != __builtin_bswap16(0x0000)) {
+	if (m_E131.pE131Packet->Data.DMPLayer.FirstAddressProperty != __builtin_bswap16(0x0000)) {
 		return false;
 	}
 
 	// Transmitters shall set the DMP Layer's Address Increment to 0x0001. Receivers shall discard the packet if
 	// the received value is not 0x0001.
-	if (m_E131.E131Packet.Data.DMPLayer.AddressIncrement != __builtin_bswap16(0x0001)) {
+	if (m_E131.pE131Packet->Data.DMPLayer.AddressIncrement != __builtin_bswap16(0x0001)) {
 		return false;
 	}
 
 	return true;
 }
 
+void E131Bridge::HandlePacket() {
+	if (__builtin_expect((!IsValidRoot()), 0)) {
+		return;
+	}
+
+	m_State.IsNetworkDataLoss = false;
+	m_nPreviousPacketMillis = m_nCurrentPacketMillis;
+
+	if (m_State.IsSynchronized && !m_State.IsForcedSynchronized) {
+		if ((m_nCurrentPacketMillis - m_State.SynchronizationTime) >= (E131_NETWORK_DATA_LOSS_TIMEOUT_SECONDS * 1000)) {
+			m_State.IsSynchronized = false;
+		}
+	}
+
+	const uint32_t nRootVector = __builtin_bswap32(m_E131.pE131Packet->Raw.RootLayer.Vector);
+
+	if (nRootVector == E131_VECTOR_ROOT_DATA) {
+		if (IsValidDataPacket()) {
+			HandleDmx();
+		}
+	} else if (nRootVector == E131_VECTOR_ROOT_EXTENDED) {
+		const uint32_t nFramingVector = __builtin_bswap32(m_E131.pE131Packet->Raw.FrameLayer.Vector);
+			if (nFramingVector == E131_VECTOR_EXTENDED_SYNCHRONIZATION) {
+			HandleSynchronization();
+		}
+	} else {
+		DEBUG_PRINTF("Not supported Root Vector : 0x%x", nRootVector);
+	}
+}
+
 void E131Bridge::Run() {
 	uint16_t nForeignPort;
 
-	const uint16_t nBytesReceived = Network::Get()->RecvFrom(m_nHandle, &m_E131.E131Packet, sizeof(m_E131.E131Packet), &m_E131.IPAddressFrom, &nForeignPort) ;
+	void *pBuffer;
+	uint16_t nBytesReceived = Network::Get()->RecvLease(m_nHandle, &pBuffer, &m_E131.IPAddressFrom, &nForeignPort);
 
 	m_nCurrentPacketMillis = Hardware::Get()->Millis();
 
+	m_LightSetFrame.Run(m_nCurrentPacketMillis);
+
 	if (__builtin_expect((nBytesReceived == 0), 1)) {
 		if (m_State.nActiveOutputPorts != 0) {
 			if (!m_State.bDisableNetworkDataLossTimeout && ((m_nCurrentPacketMillis - m_nPreviousPacketMillis) >= (E131_NETWORK_DATA_LOSS_TIMEOUT_SECONDS * 1000))) {
@@ -876,32 +881,37 @@ void E131Bridge::Run() {
 		return;
 	}
 
-	if (__builtin_expect((!IsValidRoot()), 0)) {
-		return;
-	}
+	const uint32_t nMicrosBegin = Hardware::Get()->Micros();
+	uint32_t nPackets = 0;
 
-	m_State.IsNetworkDataLoss = false;
-	m_nPreviousPacketMillis = m_nCurrentPacketMillis;
+	// Drain the receive queue, bounded by the number of packets and the time
+	for (;;) {
+		m_E131.pE131Packet = reinterpret_cast<union UE131Packet*>(pBuffer);
 
-	if (m_State.IsSynchronized && !m_State.IsForcedSynchronized) {
-		if ((m_nCurrentPacketMillis - m_State.SynchronizationTime) >= (E131_NETWORK_DATA_LOSS_TIMEOUT_SECONDS * 1000)) {
-			m_State.IsSynchronized = false;
-		}
-	}
+		HandlePacket();
 
-	const uint32_t nRootVector = __builtin_bswap32(m_E131.E131Packet.Raw.RootLayer.Vector);
+		Network::Get()->Release(m_nHandle);
 
-	if (nRootVector == E131_VECTOR_ROOT_DATA) {
-		if (IsValidDataPacket()) {
-			HandleDmx();
+		nPackets++;
+
+		if ((nPackets >= m_nDrainPackets) || ((Hardware::Get()->Micros() - nMicrosBegin) >= m_nDrainMicros)) {
+			m_RunStats.nBurstLimited++;
+			break;
 		}
-	} else if (nRootVector == E131_VECTOR_ROOT_EXTENDED) {
-		const uint32_t nFramingVector = __builtin_bswap32(m_E131.E131Packet.Raw.FrameLayer.Vector);
-			if (nFramingVector == E131_VECTOR_EXTENDED_SYNCHRONIZATION) {
-			HandleSynchronization();
+
+		Network::Get()->Run();
+
+		nBytesReceived = Network::Get()->RecvLease(m_nHandle, &pBuffer, &m_E131.IPAddressFrom, &nForeignPort);
+
+		if (nBytesReceived == 0) {
+			break;
 		}
-	} else {
-		DEBUG_PRINTF("Not supported Root Vector : 0x%x", nRootVector);
+	}
+
+	m_RunStats.nPackets += nPackets;
+
+	if (nPackets > m_RunStats.nBurstMax) {
+		m_RunStats.nBurstMax = nPackets;
 	}
 
 	if (m_pE131DmxIn != nullptr) {
@@ -918,3 +928,30 @@ void E131Bridge::Run() {
 		}
 	}
 }
+
+uint32_t E131Bridge::GetTimeoutMillis() const {
+	if (m_pE131DmxIn != nullptr) {
+		return 0;
+	}
+
+	const uint32_t nMillis = Hardware::Get()->Millis();
+	const uint32_t nElapsed = nMillis - m_nPreviousPacketMillis;
+
+	uint32_t nTimeoutMillis = m_LightSetFrame.GetTimeoutMillis(nMillis);
+
+	if (m_State.nActiveOutputPorts != 0) {
+		if (!m_State.bDisableNetworkDataLossTimeout && !m_State.IsNetworkDataLoss) {
+			const auto nDataLossMillis = static_cast<uint32_t>(E131_NETWORK_DATA_LOSS_TIMEOUT_SECONDS * 1000);
+
+			if (nElapsed < nDataLossMillis) {
+				nTimeoutMillis = std::min(nTimeoutMillis, nDataLossMillis - nElapsed);
+			}
+		}
+
+		if (m_bEnableDataIndicator && m_State.bIsReceivingDmx && (nElapsed < 1000)) {
+			nTimeoutMillis = std::min(nTimeoutMillis, 1000 - nElapsed);
+		}
+	}
+
+	return nTimeoutMillis;
+}
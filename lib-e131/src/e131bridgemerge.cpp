@@ -0,0 +1,330 @@
+/**
+ * @file e131bridgemerge.cpp
+ *
+ */
+/* Copyright (C) 2020 by Arjan van Vught mailto:info@orangepi-dmx.nl
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include <stdint.h>
+#include <string.h>
+#include <cassert>
+
+#include "e131bridge.h"
+
+#include "lightsetdata.h"
+
+#include "network.h"
+
+#include "debug.h"
+
+/**
+ * The sources of a universe are identified by their CID.
+ * The folded CID is compared first, the full CID only when it matches.
+ */
+int32_t E131Bridge::GetSource(uint32_t nPortIndex, const uint32_t *pCid, uint32_t nCidHash) const {
+	const struct TE131OutputPort &port = m_OutputPort[nPortIndex];
+
+	for (uint32_t nSource = 0; nSource < port.nSources; nSource++) {
+		const struct TSource &source = port.aSources[nSource];
+
+		if ((source.nCidHash == nCidHash)
+				&& (source.aCid[0] == pCid[0]) && (source.aCid[1] == pCid[1])
+				&& (source.aCid[2] == pCid[2]) && (source.aCid[3] == pCid[3])) {
+			return static_cast<int32_t>(nSource);
+		}
+	}
+
+	return -1;
+}
+
+/**
+ * The data of a single source is not buffered, it is in the port data.
+ * When the merge starts it is copied into a pool buffer.
+ */
+int32_t E131Bridge::AddSource(uint32_t nPortIndex, const uint32_t *pCid, uint32_t nCidHash) {
+	struct TE131OutputPort &port = m_OutputPort[nPortIndex];
+
+	if (port.nSources >= E131_MERGE_SOURCES_MAX) {
+		return -1;
+	}
+
+	struct TSource &source = port.aSources[port.nSources];
+
+	if (port.nSources == 1) {
+		struct TSource &first = port.aSources[0];
+		assert(first.pData == nullptr);
+
+		first.pData = m_MergePool.Get();
+
+		if (first.pData == nullptr) {
+			return -1;
+		}
+
+		first.nLength = port.length;
+		memcpy(first.pData, port.data, port.length);
+
+		source.pData = m_MergePool.Get();
+
+		if (source.pData == nullptr) {
+			m_MergePool.Put(first.pData);
+			first.pData = nullptr;
+			return -1;
+		}
+	} else if (port.nSources > 1) {
+		source.pData = m_MergePool.Get();
+
+		if (source.pData == nullptr) {
+			return -1;
+		}
+	} else {
+		source.pData = nullptr;
+	}
+
+	source.pPriority = nullptr;
+	memcpy(source.aCid, pCid, E131_CID_LENGTH);
+	source.nCidHash = nCidHash;
+	source.nMillis = m_nCurrentPacketMillis;
+	source.nLength = 0;
+	source.nSynchronizationAddress = 0;
+
+	return static_cast<int32_t>(port.nSources++);
+}
+
+void E131Bridge::RemoveSource(uint32_t nPortIndex, uint32_t nSource) {
+	struct TE131OutputPort &port = m_OutputPort[nPortIndex];
+
+	assert(nSource < port.nSources);
+
+	if (port.aSources[nSource].pData != nullptr) {
+		m_MergePool.Put(port.aSources[nSource].pData);
+	}
+
+	if (port.aSources[nSource].pPriority != nullptr) {
+		m_MergePool.Put(port.aSources[nSource].pPriority);
+	}
+
+	const uint16_t nSynchronizationAddress = port.aSources[nSource].nSynchronizationAddress;
+
+	port.nSources--;
+	port.aSources[nSource] = port.aSources[port.nSources];
+	port.aSources[port.nSources].pData = nullptr;
+	port.aSources[port.nSources].pPriority = nullptr;
+	port.aSources[port.nSources].nSynchronizationAddress = 0;
+
+	if (port.nSources <= 1) {
+		// A single source is not buffered
+		if ((port.nSources == 1) && (port.aSources[0].pData != nullptr)) {
+			m_MergePool.Put(port.aSources[0].pData);
+			port.aSources[0].pData = nullptr;
+		}
+
+		port.IsMerging = false;
+	}
+
+	if (port.nSources == 0) {
+		port.nPriority = E131_PRIORITY_LOWEST;
+	}
+
+	if (nSynchronizationAddress != 0) {
+		LeaveSynchronizationAddress(nSynchronizationAddress);
+	}
+}
+
+void E131Bridge::RemoveSources(uint32_t nPortIndex) {
+	while (m_OutputPort[nPortIndex].nSources != 0) {
+		RemoveSource(nPortIndex, m_OutputPort[nPortIndex].nSources - 1U);
+	}
+}
+
+bool E131Bridge::IsDmxDataChanged(uint8_t nPortIndex, const uint8_t *pData, uint16_t nLength) {
+	assert(nPortIndex < E131_MAX_PORTS);
+	assert(pData != nullptr);
+
+	if (nLength != m_OutputPort[nPortIndex].length) {
+		m_OutputPort[nPortIndex].length = nLength;
+		memcpy(m_OutputPort[nPortIndex].data, pData, E131_DMX_LENGTH);
+		lightset::data::SetAll(m_OutputPort[nPortIndex].tDirty, nLength);
+		return true;
+	}
+
+	struct TLightSetDirty tDirty;
+	const bool isChanged = lightset::data::Copy(m_OutputPort[nPortIndex].data, pData, E131_DMX_LENGTH, tDirty);
+	lightset::data::Add(m_OutputPort[nPortIndex].tDirty, tDirty);
+
+	return isChanged;
+}
+
+bool E131Bridge::IsMergedDmxDataChanged(uint8_t nPortIndex, const uint8_t *pData, uint16_t nLength) {
+	assert(nPortIndex < E131_MAX_PORTS);
+	assert(pData != nullptr);
+
+	if (!m_State.IsMergeMode) {
+		m_State.IsMergeMode = true;
+		m_State.IsChanged = true;
+	}
+
+	struct TE131OutputPort &port = m_OutputPort[nPortIndex];
+
+	port.IsMerging = true;
+
+	if (port.mergeMode == E131Merge::LTP) {
+		return IsDmxDataChanged(nPortIndex, pData, nLength);
+	}
+
+	// The sources are merged over the longest, missing slots of the shorter sources are 0
+	const uint8_t *pSources[E131_MERGE_SOURCES_MAX];
+	const uint8_t *pPriorities[E131_MERGE_SOURCES_MAX];
+	uint16_t nMergeLength = 0;
+	bool bHasPriorities = false;
+
+	for (uint32_t nSource = 0; nSource < port.nSources; nSource++) {
+		pSources[nSource] = port.aSources[nSource].pData;
+		pPriorities[nSource] = port.aSources[nSource].pPriority;
+		bHasPriorities |= (pPriorities[nSource] != nullptr);
+		if (port.aSources[nSource].nLength > nMergeLength) {
+			nMergeLength = port.aSources[nSource].nLength;
+		}
+	}
+
+	struct TLightSetDirty tDirty;
+	bool isChanged;
+
+	if (__builtin_expect((!bHasPriorities), 1)) {
+		isChanged = lightset::data::MergeHtp(port.data, pSources, port.nSources, nMergeLength, tDirty);
+	} else {
+		// A source without per-address priorities has the universe priority for all slots
+		memset(m_UniversePriority, port.nPriority, E131_DMX_LENGTH);
+
+		for (uint32_t nSource = 0; nSource < port.nSources; nSource++) {
+			if (pPriorities[nSource] == nullptr) {
+				pPriorities[nSource] = m_UniversePriority;
+			}
+		}
+
+		isChanged = lightset::data::MergeHtpPriority(port.data, pSources, pPriorities, port.nSources, nMergeLength, tDirty);
+	}
+
+	if (nMergeLength != port.length) {
+		port.length = nMergeLength;
+		lightset::data::SetAll(port.tDirty, nMergeLength);
+		return true;
+	}
+
+	lightset::data::Add(port.tDirty, tDirty);
+	return isChanged;
+}
+
+void E131Bridge::CheckMergeTimeouts(uint8_t nPortIndex) {
+	assert(nPortIndex < E131_MAX_PORTS);
+
+	struct TE131OutputPort &port = m_OutputPort[nPortIndex];
+
+	const bool bWasMerging = (port.nSources > 1);
+
+	for (uint32_t nSource = port.nSources; nSource-- > 0;) {
+		struct TSource &source = port.aSources[nSource];
+
+		if ((m_nCurrentPacketMillis - source.nMillis) > (E131_MERGE_TIMEOUT_SECONDS * 1000)) {
+			RemoveSource(nPortIndex, nSource);
+		} else if ((source.pPriority != nullptr) && ((m_nCurrentPacketMillis - source.nPriorityMillis) > (E131_PRIORITY_TIMEOUT_SECONDS * 1000))) {
+			// The source falls back to the universe priority
+			m_MergePool.Put(source.pPriority);
+			source.pPriority = nullptr;
+		}
+	}
+
+	if (bWasMerging && (port.nSources <= 1)) {
+		UpdateMergeMode();
+	}
+}
+
+void E131Bridge::UpdateMergeMode() {
+	bool bIsMerging = false;
+
+	for (uint32_t i = 0; i < E131_MAX_PORTS; i++) {
+		bIsMerging |= m_OutputPort[i].IsMerging;
+	}
+
+	if (!bIsMerging && m_State.IsMergeMode) {
+		m_State.IsChanged = true;
+		m_State.IsMergeMode = false;
+	}
+}
+
+/**
+ * 6.2.3 Priority
+ * A lower priority source takes over when none of the sources of the universe has been seen for E131_PRIORITY_TIMEOUT_SECONDS
+ */
+bool E131Bridge::IsPriorityTimeOut(uint8_t nPortIndex) {
+	assert(nPortIndex < E131_MAX_PORTS);
+
+	const struct TE131OutputPort &port = m_OutputPort[nPortIndex];
+
+	for (uint32_t nSource = 0; nSource < port.nSources; nSource++) {
+		if ((m_nCurrentPacketMillis - port.aSources[nSource].nMillis) < (E131_PRIORITY_TIMEOUT_SECONDS * 1000)) {
+			return false;
+		}
+	}
+
+	return true;
+}
+
+void E131Bridge::SetSynchronizationAddress(uint32_t nPortIndex, uint32_t nSource, uint16_t nSynchronizationAddress) {
+	assert(nPortIndex < E131_MAX_PORTS);
+	assert(nSource < m_OutputPort[nPortIndex].nSources);
+	assert(nSynchronizationAddress != 0);
+
+	struct TSource &source = m_OutputPort[nPortIndex].aSources[nSource];
+
+	if (source.nSynchronizationAddress == nSynchronizationAddress) {
+		return;
+	}
+
+	DEBUG_PRINTF("nPortIndex=%d, nSource=%d, nSynchronizationAddress=%d", static_cast<int>(nPortIndex), static_cast<int>(nSource), nSynchronizationAddress);
+
+	if (source.nSynchronizationAddress != 0) {
+		LeaveSynchronizationAddress(source.nSynchronizationAddress);
+	}
+
+	source.nSynchronizationAddress = nSynchronizationAddress;
+	m_UniverseIndex[AddUniverse(nSynchronizationAddress)].nSynchronizationRefs++;
+}
+
+bool E131Bridge::IsSynchronizationAddress(uint16_t nSynchronizationAddress) const {
+	const int32_t nIndex = FindUniverse(nSynchronizationAddress);
+
+	return (nIndex >= 0) && (m_UniverseIndex[nIndex].nSynchronizationRefs != 0);
+}
+
+/**
+ * A source no longer uses the synchronization address.
+ * The group is left when no other source uses it and it is not the universe of an output port.
+ */
+void E131Bridge::LeaveSynchronizationAddress(uint16_t nSynchronizationAddress) {
+	const int32_t nIndex = FindUniverse(nSynchronizationAddress);
+
+	assert(nIndex >= 0);
+	assert(m_UniverseIndex[nIndex].nSynchronizationRefs != 0);
+
+	m_UniverseIndex[nIndex].nSynchronizationRefs--;
+
+	ReleaseUniverse(static_cast<uint32_t>(nIndex));
+}
@@ -50,9 +50,11 @@ void E131Bridge::Print() {
 		for (uint32_t nPortIndex = 0; nPortIndex < E131_MAX_PORTS; nPortIndex++) {
 			uint16_t nUniverse;
 			if (GetUniverse(nPortIndex, nUniverse, E131_OUTPUT_PORT)) {
-				printf("  Port %2d Universe %-3d [%s]\n", nPortIndex, nUniverse, E131::GetMergeMode(m_OutputPort[nPortIndex].mergeMode, true));
+				printf("  Port %2d Universe %-3d [%s:%d]\n", nPortIndex, nUniverse, E131::GetMergeMode(m_OutputPort[nPortIndex].mergeMode, true), E131_MERGE_SOURCES_MAX);
 			}
 		}
+
+		printf(" Merge buffers : %d\n", static_cast<int>(m_nMergeBuffers));
 	}
 
 	if (m_State.nActiveInputPorts != 0) {
@@ -46,6 +46,20 @@ enum TNetwork {
 #define MAC2STR(mac) static_cast<int>(mac[0]),static_cast<int>(mac[1]),static_cast<int>(mac[2]),static_cast<int>(mac[3]), static_cast<int>(mac[4]), static_cast<int>(mac[5])
 #define MACSTR "%.2x:%.2x:%.2x:%.2x:%.2x:%.2x"
 
+struct TNetworkRecv {
+	void *pBuffer;
+	uint32_t nFromIp;
+	uint16_t nLength;	///< In: the size of pBuffer, out: the number of bytes received
+	uint16_t nFromPort;
+};
+
+struct TNetworkSend {
+	const void *pBuffer;
+	uint32_t nToIp;
+	uint16_t nLength;
+	uint16_t nRemotePort;
+};
+
 class NetworkStore {
 public:
 	virtual ~NetworkStore() {}
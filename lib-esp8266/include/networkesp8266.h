@@ -50,6 +50,9 @@ public:
 	uint16_t RecvFrom(int32_t nHandle, void *pBuffer, uint16_t nLength, uint32_t *pFromIp, uint16_t *pFromPort);
 	void SendTo(int32_t nHandle, const void *pBuffer, uint16_t nLength, uint32_t nToIp, uint16_t nRemotePort);
 
+	uint32_t RecvFromBatch(int32_t nHandle, struct TNetworkRecv *pRecv, uint32_t nCount);
+	void SendToBatch(int32_t nHandle, const struct TNetworkSend *pSend, uint32_t nCount);
+
 	void Print(void) {
 
 	}
@@ -94,3 +94,23 @@ uint16_t NetworkESP8266::RecvFrom(int32_t nHandle, void *packet, uint16_t size,
 void NetworkESP8266::SendTo(int32_t nHandle, const void *packet, uint16_t size, uint32_t to_ip, uint16_t remote_port) {
 	wifi_udp_sendto(reinterpret_cast<const uint8_t*>(packet), size, to_ip, remote_port);
 }
+
+uint32_t NetworkESP8266::RecvFromBatch(int32_t nHandle, struct TNetworkRecv *pRecv, uint32_t nCount) {
+	uint32_t i;
+
+	for (i = 0; i < nCount; i++) {
+		pRecv[i].nLength = wifi_udp_recvfrom(reinterpret_cast<uint8_t*>(pRecv[i].pBuffer), pRecv[i].nLength, &pRecv[i].nFromIp, &pRecv[i].nFromPort);
+
+		if (pRecv[i].nLength == 0) {
+			break;
+		}
+	}
+
+	return i;
+}
+
+void NetworkESP8266::SendToBatch(int32_t nHandle, const struct TNetworkSend *pSend, uint32_t nCount) {
+	for (uint32_t i = 0; i < nCount; i++) {
+		wifi_udp_sendto(reinterpret_cast<const uint8_t*>(pSend[i].pBuffer), pSend[i].nLength, pSend[i].nToIp, pSend[i].nRemotePort);
+	}
+}
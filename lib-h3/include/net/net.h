@@ -41,6 +41,12 @@ struct ip_info {
     struct ip_addr gw;
 };
 
+struct udp_queue_stats {
+	uint32_t depth;			// The number of datagrams the queue can hold
+	uint32_t high_water;	// The maximum number of datagrams queued
+	uint32_t drops;			// Datagrams dropped because the queue was full
+};
+
 #define IP_BROADCAST	((uint32_t) 0xFFFFFFFF)
 #define HOST_NAME_MAX 	64	/* including a terminating null byte. */
 
@@ -62,6 +68,10 @@ extern void net_dhcp_release(void);
 extern int udp_bind(uint16_t);
 extern int udp_unbind(uint16_t);
 extern uint16_t udp_recv(uint8_t, uint8_t *, uint16_t, uint32_t *, uint16_t *);
+extern uint16_t udp_recv_lease(uint8_t, uint8_t **, uint32_t *, uint16_t *);
+extern void udp_release(uint8_t);
+extern int udp_set_queue_depth(uint8_t, uint32_t);
+extern void udp_get_queue_stats(uint8_t, struct udp_queue_stats *);
 extern int udp_send(uint8_t, const uint8_t *, uint16_t, uint32_t, uint16_t);
 //
 extern int igmp_join(uint32_t);
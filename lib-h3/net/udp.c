@@ -54,8 +54,9 @@ extern uint32_t arp_cache_lookup(uint32_t, uint8_t *);
 extern uint16_t net_chksum(void *, uint32_t);
 
 #define MAX_PORTS_ALLOWED	16
-#define MAX_ENTRIES			(1 << 2) // Must always be a power of 2
-#define MAX_ENTRIES_MASK	(MAX_ENTRIES - 1)
+#define MAX_ENTRIES			(1 << 5) // Must always be a power of 2
+#define MAX_ENTRIES_POOL	128		 // Shared by all the bound ports
+#define ENTRIES_DEFAULT		(1 << 2) // Must always be a power of 2
 
 struct queue_entry {
 	uint8_t data[FRAME_BUFFER_SIZE];
@@ -67,7 +68,10 @@ struct queue_entry {
 struct queue {
 	uint32_t queue_head;
 	uint32_t queue_tail;
-	struct queue_entry entries[MAX_ENTRIES] ALIGNED;
+	uint32_t queue_mask;	// The queue depth minus 1, 0 when the port is not bound
+	uint32_t high_water;
+	uint32_t drops;
+	struct queue_entry *entries[MAX_ENTRIES];
 }ALIGNED;
 
 typedef union pcast32 {
@@ -77,6 +81,9 @@ typedef union pcast32 {
 
 static uint32_t s_ports_allowed[MAX_PORTS_ALLOWED] ALIGNED;
 static struct queue s_recv_queue[MAX_PORTS_ALLOWED] ALIGNED;
+static struct queue_entry s_entries_pool[MAX_ENTRIES_POOL] ALIGNED;
+static struct queue_entry *s_entries_free[MAX_ENTRIES_POOL];
+static uint32_t s_entries_free_count;
 static struct t_udp s_send_packet ALIGNED;
 static uint16_t s_id ALIGNED;
 static uint32_t broadcast_mask;
@@ -94,10 +101,15 @@ void __attribute__((cold)) udp_init(const uint8_t *mac_address, const struct ip_
 
 	for (i = 0; i < MAX_PORTS_ALLOWED; i++) {
 		s_ports_allowed[i] = 0;
-		s_recv_queue[i].queue_head = 0;
-		s_recv_queue[i].queue_tail = 0;
+		memset(&s_recv_queue[i], 0, sizeof(struct queue));
 	}
 
+	for (i = 0; i < MAX_ENTRIES_POOL; i++) {
+		s_entries_free[i] = &s_entries_pool[i];
+	}
+
+	s_entries_free_count = MAX_ENTRIES_POOL;
+
 	s_id = 0;
 
 	// Ethernet
@@ -146,8 +158,18 @@ void udp_handle(struct t_udp *p_udp) {
 		return;
 	}
 
-	const uint32_t entry = s_recv_queue[port_index].queue_tail;
-	struct queue_entry *p_queue_entry = &s_recv_queue[port_index].entries[entry];
+	struct queue *p_queue = &s_recv_queue[port_index];
+
+	const uint32_t entry = p_queue->queue_head;
+	const uint32_t next = (entry + 1) & p_queue->queue_mask;
+
+	// The queue is full, the entry at queue_tail can be leased out
+	if (__builtin_expect ((next == p_queue->queue_tail), 0)) {
+		p_queue->drops++;
+		return;
+	}
+
+	struct queue_entry *p_queue_entry = p_queue->entries[entry];
 
 	const uint32_t data_length = __builtin_bswap16(p_udp->udp.len) - UDP_HEADER_SIZE;
 
@@ -162,7 +184,45 @@ void udp_handle(struct t_udp *p_udp) {
 	p_queue_entry->from_port = __builtin_bswap16(p_udp->udp.source_port);
 	p_queue_entry->size = i;
 
-	s_recv_queue[port_index].queue_head = (s_recv_queue[port_index].queue_head + 1) & MAX_ENTRIES_MASK;
+	p_queue->queue_head = next;
+
+	const uint32_t used = (next - p_queue->queue_tail) & p_queue->queue_mask;
+
+	if (used > p_queue->high_water) {
+		p_queue->high_water = used;
+	}
+}
+
+static void queue_free(struct queue *p_queue) {
+	uint32_t i;
+
+	if (p_queue->queue_mask == 0) {
+		return;
+	}
+
+	for (i = 0; i <= p_queue->queue_mask; i++) {
+		s_entries_free[s_entries_free_count++] = p_queue->entries[i];
+	}
+
+	memset(p_queue, 0, sizeof(struct queue));
+}
+
+static int queue_alloc(struct queue *p_queue, uint32_t depth) {
+	uint32_t i;
+
+	if (s_entries_free_count < depth) {
+		return -1;
+	}
+
+	memset(p_queue, 0, sizeof(struct queue));
+
+	for (i = 0; i < depth; i++) {
+		p_queue->entries[i] = s_entries_free[--s_entries_free_count];
+	}
+
+	p_queue->queue_mask = depth - 1;
+
+	return 0;
 }
 
 // -->
@@ -187,6 +247,11 @@ int udp_bind(uint16_t local_port) {
 		return -1;
 	}
 
+	if (queue_alloc(&s_recv_queue[i], ENTRIES_DEFAULT) < 0) {
+		console_error("bind: queue");
+		return -1;
+	}
+
 	s_ports_allowed[i] = local_port;
 
 	DEBUG_PRINTF("i=%d, local_port=%d", i, local_port);
@@ -200,8 +265,7 @@ int udp_unbind(uint16_t local_port) {
 	for (uint32_t i = 0; i < MAX_PORTS_ALLOWED; i++) {
 		if (s_ports_allowed[i] == local_port) {
 			s_ports_allowed[i] = 0;
-			s_recv_queue[i].queue_head = 0;
-			s_recv_queue[i].queue_tail = 0;
+			queue_free(&s_recv_queue[i]);
 			return 0;
 		}
 	}
@@ -217,8 +281,8 @@ uint16_t udp_recv(uint8_t idx, uint8_t *packet, uint16_t size, uint32_t *from_ip
 		return 0;
 	}
 
-	const uint8_t entry = s_recv_queue[idx].queue_tail;
-	struct queue_entry *p_queue_entry = &s_recv_queue[idx].entries[entry];
+	const uint32_t entry = s_recv_queue[idx].queue_tail;
+	struct queue_entry *p_queue_entry = s_recv_queue[idx].entries[entry];
 
 	const uint16_t i = MIN(size, p_queue_entry->size);
 
@@ -227,13 +291,78 @@ uint16_t udp_recv(uint8_t idx, uint8_t *packet, uint16_t size, uint32_t *from_ip
 	*from_ip = p_queue_entry->from_ip;
 	*from_port = p_queue_entry->from_port;
 
-	s_recv_queue[idx].queue_tail = (s_recv_queue[idx].queue_tail + 1) & MAX_ENTRIES_MASK;
+	s_recv_queue[idx].queue_tail = (s_recv_queue[idx].queue_tail + 1) & s_recv_queue[idx].queue_mask;
 
 	DEBUG_PRINTF("[%d] %d[%d]: %d " IPSTR, H3_TIMER->AVS_CNT0, idx, s_ports_allowed[idx], i, IP2STR(*from_ip));
 
 	return i;
 }
 
+/*
+ * Zero-copy receive. The entry stays in the queue until udp_release.
+ */
+uint16_t udp_recv_lease(uint8_t idx, uint8_t **packet, uint32_t *from_ip, uint16_t *from_port) {
+	assert(idx < MAX_PORTS_ALLOWED);
+
+	if (s_recv_queue[idx].queue_head == s_recv_queue[idx].queue_tail) {
+		return 0;
+	}
+
+	struct queue_entry *p_queue_entry = s_recv_queue[idx].entries[s_recv_queue[idx].queue_tail];
+
+	*packet = p_queue_entry->data;
+	*from_ip = p_queue_entry->from_ip;
+	*from_port = p_queue_entry->from_port;
+
+	return p_queue_entry->size;
+}
+
+void udp_release(uint8_t idx) {
+	assert(idx < MAX_PORTS_ALLOWED);
+	assert(s_recv_queue[idx].queue_head != s_recv_queue[idx].queue_tail);
+
+	s_recv_queue[idx].queue_tail = (s_recv_queue[idx].queue_tail + 1) & s_recv_queue[idx].queue_mask;
+}
+
+/*
+ * The depth is rounded up to a power of 2, one entry is always kept free.
+ * Pending datagrams are discarded.
+ */
+int udp_set_queue_depth(uint8_t idx, uint32_t depth) {
+	assert(idx < MAX_PORTS_ALLOWED);
+
+	struct queue *p_queue = &s_recv_queue[idx];
+	uint32_t size = 2;
+
+	if (s_ports_allowed[idx] == 0) {
+		return -1;
+	}
+
+	while ((size <= depth) && (size < MAX_ENTRIES)) {
+		size <<= 1;
+	}
+
+	const uint32_t size_previous = p_queue->queue_mask + 1;
+
+	queue_free(p_queue);
+
+	if (queue_alloc(p_queue, size) < 0) {
+		console_error("udp_set_queue_depth");
+		queue_alloc(p_queue, size_previous);
+		return -1;
+	}
+
+	return 0;
+}
+
+void udp_get_queue_stats(uint8_t idx, struct udp_queue_stats *p_stats) {
+	assert(idx < MAX_PORTS_ALLOWED);
+
+	p_stats->depth = s_recv_queue[idx].queue_mask;
+	p_stats->high_water = s_recv_queue[idx].high_water;
+	p_stats->drops = s_recv_queue[idx].drops;
+}
+
 int udp_send(uint8_t idx, const uint8_t *packet, uint16_t size, uint32_t to_ip, uint16_t remote_port) {
 	assert(idx < MAX_PORTS_ALLOWED);
 
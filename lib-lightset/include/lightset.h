@@ -29,6 +29,7 @@
 #include <stdint.h>
 
 #include "lightsetdisplay.h"
+#include "lightsetdata.h"
 
 #include "debug.h"
 
@@ -62,6 +63,32 @@ public:
 
 	virtual void SetData(uint8_t nPort, const uint8_t *pData, uint16_t nLength)= 0;
 
+	/**
+	 * Optional. Only the slots within tDirty have changed since the previous call for nPort.
+	 * The default falls back to a full SetData.
+	 */
+	virtual void SetDataRange(uint8_t nPort, const uint8_t *pData, uint16_t nLength, const struct TLightSetDirty &tDirty) {
+		(void)tDirty;
+		SetData(nPort, pData, nLength);
+	}
+
+	/**
+	 * Optional frame lifecycle: FrameBegin, one or more SetData / SetDataRange, FrameCommit.
+	 * An output that implements it shows the frame on FrameCommit only.
+	 * Callers that never call FrameBegin keep the per SetData behaviour.
+	 */
+	virtual void FrameBegin() {
+	}
+	virtual void FrameCommit() {
+	}
+
+	/**
+	 * Optional, called from the main loop by the receiver driving the frame lifecycle.
+	 * An output with a frame waiting for the hardware starts it here.
+	 */
+	virtual void FrameRun() {
+	}
+
 	virtual void Print() {
 	}
 
@@ -46,6 +46,12 @@ public:
 	void Stop(uint8_t nPort) override;
 
 	void SetData(uint8_t nPort, const uint8_t *, uint16_t) override;
+	void SetDataRange(uint8_t nPort, const uint8_t *, uint16_t, const struct TLightSetDirty &) override;
+
+	void FrameBegin() override;
+	void FrameCommit() override;
+
+	void FrameRun() override;
 
 	void Print() override;
 
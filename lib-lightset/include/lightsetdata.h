@@ -0,0 +1,105 @@
+/**
+ * @file lightsetdata.h
+ *
+ */
+/* Copyright (C) 2020 by Arjan van Vught mailto:info@orangepi-dmx.nl
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#ifndef LIGHTSETDATA_H_
+#define LIGHTSETDATA_H_
+
+#include <stdint.h>
+
+/**
+ * Range of changed slots, both inclusive.
+ * Nothing has changed when nFirst > nLast.
+ */
+struct TLightSetDirty {
+	uint16_t nFirst;
+	uint16_t nLast;
+};
+
+namespace lightset {
+namespace data {
+
+inline void SetClean(struct TLightSetDirty &tDirty) {
+	tDirty.nFirst = 1;
+	tDirty.nLast = 0;
+}
+
+inline void SetAll(struct TLightSetDirty &tDirty, uint32_t nLength) {
+	if (nLength == 0) {
+		SetClean(tDirty);
+		return;
+	}
+	tDirty.nFirst = 0;
+	tDirty.nLast = static_cast<uint16_t>(nLength - 1);
+}
+
+inline bool IsClean(const struct TLightSetDirty &tDirty) {
+	return tDirty.nFirst > tDirty.nLast;
+}
+
+/**
+ * Extend tDirty so it also covers tOther.
+ */
+inline void Add(struct TLightSetDirty &tDirty, const struct TLightSetDirty &tOther) {
+	if (IsClean(tOther)) {
+		return;
+	}
+	if (IsClean(tDirty)) {
+		tDirty = tOther;
+		return;
+	}
+	if (tOther.nFirst < tDirty.nFirst) {
+		tDirty.nFirst = tOther.nFirst;
+	}
+	if (tOther.nLast > tDirty.nLast) {
+		tDirty.nLast = tOther.nLast;
+	}
+}
+
+/**
+ * Copy pSrc into pDst (LTP) and return true when at least one slot has changed.
+ */
+bool Copy(uint8_t *pDst, const uint8_t *pSrc, uint32_t nLength, struct TLightSetDirty &tDirty);
+
+/**
+ * Store the highest value of pSrcA and pSrcB into pDst (HTP) and return true when at least one slot has changed.
+ */
+bool MergeHtp(uint8_t *pDst, const uint8_t *pSrcA, const uint8_t *pSrcB, uint32_t nLength, struct TLightSetDirty &tDirty);
+
+/**
+ * Store the highest value of the nSources buffers in pSrc into pDst (HTP) and return true when at least one slot has changed.
+ */
+bool MergeHtp(uint8_t *pDst, const uint8_t * const *pSrc, uint32_t nSources, uint32_t nLength, struct TLightSetDirty &tDirty);
+
+/**
+ * Per slot the source with the highest priority in pPriority wins, equal priorities are merged HTP.
+ * Priority 0 is a slot not provided by that source, a slot without any source is 0.
+ * Return true when at least one slot has changed.
+ */
+bool MergeHtpPriority(uint8_t *pDst, const uint8_t * const *pSrc, const uint8_t * const *pPriority, uint32_t nSources, uint32_t nLength, struct TLightSetDirty &tDirty);
+
+}  // namespace data
+}  // namespace lightset
+
+#endif /* LIGHTSETDATA_H_ */
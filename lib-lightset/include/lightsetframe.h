@@ -0,0 +1,98 @@
+/**
+ * @file lightsetframe.h
+ *
+ */
+/* Copyright (C) 2020 by Arjan van Vught mailto:info@orangepi-dmx.nl
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#ifndef LIGHTSETFRAME_H_
+#define LIGHTSETFRAME_H_
+
+#include <stdint.h>
+
+#include "lightset.h"
+
+/**
+ * Drives the LightSet frame lifecycle (FrameBegin / SetDataRange / FrameCommit) for a receiver.
+ *
+ * A frame is committed when all patched ports have been received,
+ * when a port is received for the second time (a universe has been skipped),
+ * or when the deadline since the first port of the frame has expired.
+ */
+class LightSetFrame {
+public:
+	static constexpr uint32_t MAX_PORTS = 64;
+	static constexpr uint32_t DEADLINE_MILLIS_DEFAULT = 25;
+
+	void SetLightSet(LightSet *pLightSet) {
+		m_pLightSet = pLightSet;
+	}
+
+	void SetPortMask(uint64_t nPortMask) {
+		m_nPortMask = nPortMask;
+	}
+
+	void SetDeadline(uint32_t nDeadlineMillis) {
+		m_nDeadlineMillis = nDeadlineMillis;
+	}
+	uint32_t GetDeadline() const {
+		return m_nDeadlineMillis;
+	}
+
+	void PortBegin(uint32_t nPortIndex, uint32_t nMillis);
+	void SetData(uint8_t nPortIndex, const uint8_t *pData, uint16_t nLength, const struct TLightSetDirty &tDirty);
+	void PortEnd(uint32_t nPortIndex);
+
+	void Commit();
+
+	/**
+	 * Milliseconds until Run() commits the pending frame, UINT32_MAX when there is none
+	 */
+	uint32_t GetTimeoutMillis(uint32_t nMillis) const {
+		if (m_nPortMaskReceived == 0) {
+			return UINT32_MAX;
+		}
+
+		const uint32_t nElapsed = nMillis - m_nMillisFirst;
+
+		return (nElapsed >= m_nDeadlineMillis) ? 0 : (m_nDeadlineMillis - nElapsed);
+	}
+
+	void Run(uint32_t nMillis) {
+		if ((m_nPortMaskReceived != 0) && ((nMillis - m_nMillisFirst) >= m_nDeadlineMillis)) {
+			Commit();
+		}
+
+		if (m_pLightSet != nullptr) {
+			m_pLightSet->FrameRun();
+		}
+	}
+
+private:
+	LightSet *m_pLightSet{nullptr};
+	uint64_t m_nPortMask{0};
+	uint64_t m_nPortMaskReceived{0};
+	uint32_t m_nMillisFirst{0};
+	uint32_t m_nDeadlineMillis{DEADLINE_MILLIS_DEFAULT};
+	bool m_bIsUpdated{false};
+};
+
+#endif /* LIGHTSETFRAME_H_ */
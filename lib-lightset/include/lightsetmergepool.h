@@ -0,0 +1,71 @@
+/**
+ * @file lightsetmergepool.h
+ *
+ */
+/* Copyright (C) 2020 by Arjan van Vught mailto:info@orangepi-dmx.nl
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#ifndef LIGHTSETMERGEPOOL_H_
+#define LIGHTSETMERGEPOOL_H_
+
+#include <stdint.h>
+
+#include "lightset.h"
+
+/**
+ * Fixed pool of DMX_UNIVERSE_SIZE source buffers, shared by all ports of a receiver.
+ * A buffer is only taken while a port is merging, idle ports use no merge memory.
+ */
+class LightSetMergePool {
+public:
+	LightSetMergePool() {}
+	~LightSetMergePool();
+
+	/**
+	 * Allocates nBuffers, all free. Only the first call allocates.
+	 */
+	void Setup(uint32_t nBuffers);
+
+	/**
+	 * Returns a zeroed buffer, nullptr when the pool is exhausted
+	 */
+	uint8_t *Get();
+	void Put(uint8_t *pBuffer);
+
+	uint32_t GetBuffers() const {
+		return m_nBuffers;
+	}
+	uint32_t GetFree() const {
+		return m_nFree;
+	}
+	uint32_t GetExhausted() const {
+		return m_nExhausted;
+	}
+
+private:
+	uint8_t *m_pBuffers{nullptr};
+	uint8_t **m_ppFree{nullptr};	///< Stack of free buffers
+	uint32_t m_nBuffers{0};
+	uint32_t m_nFree{0};
+	uint32_t m_nExhausted{0};		///< Number of Get calls without a free buffer
+};
+
+#endif /* LIGHTSETMERGEPOOL_H_ */
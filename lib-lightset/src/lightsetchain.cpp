@@ -72,6 +72,32 @@ void LightSetChain::SetData(uint8_t nPort, const uint8_t *pData, uint16_t nSize)
 	}
 }
 
+void LightSetChain::SetDataRange(uint8_t nPort, const uint8_t *pData, uint16_t nSize, const struct TLightSetDirty &tDirty) {
+	assert(pData != nullptr);
+
+	for (unsigned i = 0; i < m_nSize; i++) {
+		m_pTable[i].pLightSet->SetDataRange(nPort, pData, nSize, tDirty);
+	}
+}
+
+void LightSetChain::FrameBegin() {
+	for (unsigned i = 0; i < m_nSize; i++) {
+		m_pTable[i].pLightSet->FrameBegin();
+	}
+}
+
+void LightSetChain::FrameCommit() {
+	for (unsigned i = 0; i < m_nSize; i++) {
+		m_pTable[i].pLightSet->FrameCommit();
+	}
+}
+
+void LightSetChain::FrameRun() {
+	for (unsigned i = 0; i < m_nSize; i++) {
+		m_pTable[i].pLightSet->FrameRun();
+	}
+}
+
 void LightSetChain::Print() {
 	for (unsigned i = 0; i < m_nSize; i++) {
 		m_pTable[i].pLightSet->Print();
@@ -0,0 +1,308 @@
+/**
+ * @file lightsetdata.cpp
+ *
+ */
+/* Copyright (C) 2020 by Arjan van Vught mailto:info@orangepi-dmx.nl
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include <stdint.h>
+#include <string.h>
+#include <cassert>
+
+#include "lightsetdata.h"
+
+#if (__BYTE_ORDER__ != __ORDER_LITTLE_ENDIAN__)
+# error Little endian is assumed for the slot position
+#endif
+
+/*
+ * With NEON (H3, Raspberry Pi 2/3) or SSE2 (Linux hosts) the slots are processed 16 at a time,
+ * otherwise 4 at a time with SWAR (SIMD within a register).
+ */
+
+namespace lightset {
+namespace data {
+
+#if defined (__ARM_NEON) || defined (__SSE2__)
+typedef uint8_t block_t __attribute__ ((vector_size (16)));
+
+static inline block_t Max(block_t a, block_t b) {
+	return a > b ? a : b;
+}
+
+/*
+ * The slots with the higher priority p take v, equal priorities are merged HTP.
+ * Priority 0 is a slot not provided by the source.
+ */
+static inline block_t Arbitrate(block_t &priority, block_t data, block_t p, block_t v) {
+	const block_t zero = {};
+	v = (p == zero) ? zero : v;
+	const block_t merged = (p == priority) ? Max(v, data) : data;
+	data = (p > priority) ? v : merged;
+	priority = Max(p, priority);
+
+	return data;
+}
+
+static inline void Mark(block_t a, block_t b, uint32_t nOffset, int32_t &nFirst, int32_t &nLast) {
+	const block_t x = a ^ b;
+	uint64_t w[2];
+	memcpy(w, &x, sizeof(w));
+
+	if ((w[0] | w[1]) == 0) {
+		return;
+	}
+
+	if (nFirst < 0) {
+		nFirst = static_cast<int32_t>(nOffset + static_cast<uint32_t>((w[0] != 0) ? __builtin_ctzll(w[0]) : 64 + __builtin_ctzll(w[1])) / 8);
+	}
+
+	nLast = static_cast<int32_t>(nOffset + static_cast<uint32_t>((w[1] != 0) ? 127 - __builtin_clzll(w[1]) : 63 - __builtin_clzll(w[0])) / 8);
+}
+#else
+typedef uint32_t block_t;
+
+static inline uint32_t GreaterEqual(uint32_t a, uint32_t b) {
+	// Per byte a >= b, in the top bit of each byte
+	const uint32_t t = (a | 0x80808080) - (b & 0x7F7F7F7F);
+	const uint32_t ge = ((a & ~b) | (~(a ^ b) & t)) & 0x80808080;
+
+	return (ge >> 7) * 0xFF;
+}
+
+static inline uint32_t NonZero(uint32_t a) {
+	const uint32_t nz = (((a & 0x7F7F7F7F) + 0x7F7F7F7F) | a) & 0x80808080;
+
+	return (nz >> 7) * 0xFF;
+}
+
+static inline block_t Max(block_t a, block_t b) {
+	const uint32_t mask = GreaterEqual(a, b);
+
+	return (a & mask) | (b & ~mask);
+}
+
+static inline block_t Arbitrate(block_t &priority, block_t data, block_t p, block_t v) {
+	v &= NonZero(p);
+	const uint32_t ge = GreaterEqual(p, priority);
+	const uint32_t le = GreaterEqual(priority, p);
+
+	data = (v & ge & ~le) | (Max(v, data) & ge & le) | (data & ~ge);
+	priority = (p & ge) | (priority & ~ge);
+
+	return data;
+}
+
+static inline void Mark(block_t a, block_t b, uint32_t nOffset, int32_t &nFirst, int32_t &nLast) {
+	const uint32_t x = a ^ b;
+
+	if (x == 0) {
+		return;
+	}
+
+	if (nFirst < 0) {
+		nFirst = static_cast<int32_t>(nOffset + static_cast<uint32_t>(__builtin_ctz(x)) / 8);
+	}
+
+	nLast = static_cast<int32_t>(nOffset + static_cast<uint32_t>(31 - __builtin_clz(x)) / 8);
+}
+#endif
+
+static inline block_t Load(const uint8_t *p) {
+	block_t v;
+	memcpy(&v, p, sizeof(block_t));
+	return v;
+}
+
+static inline void Store(uint8_t *p, block_t v) {
+	memcpy(p, &v, sizeof(block_t));
+}
+
+static inline void Result(int32_t nFirst, int32_t nLast, struct TLightSetDirty &tDirty) {
+	if (nFirst < 0) {
+		SetClean(tDirty);
+		return;
+	}
+
+	tDirty.nFirst = static_cast<uint16_t>(nFirst);
+	tDirty.nLast = static_cast<uint16_t>(nLast);
+}
+
+bool Copy(uint8_t *pDst, const uint8_t *pSrc, uint32_t nLength, struct TLightSetDirty &tDirty) {
+	assert(pDst != nullptr);
+	assert(pSrc != nullptr);
+
+	int32_t nFirst = -1;
+	int32_t nLast = -1;
+	uint32_t i = 0;
+
+	for (; (i + sizeof(block_t)) <= nLength; i += sizeof(block_t)) {
+		const block_t src = Load(&pSrc[i]);
+		Mark(Load(&pDst[i]), src, i, nFirst, nLast);
+		Store(&pDst[i], src);
+	}
+
+	for (; i < nLength; i++) {
+		if (pDst[i] != pSrc[i]) {
+			if (nFirst < 0) {
+				nFirst = static_cast<int32_t>(i);
+			}
+			nLast = static_cast<int32_t>(i);
+			pDst[i] = pSrc[i];
+		}
+	}
+
+	Result(nFirst, nLast, tDirty);
+	return nFirst >= 0;
+}
+
+bool MergeHtp(uint8_t *pDst, const uint8_t *pSrcA, const uint8_t *pSrcB, uint32_t nLength, struct TLightSetDirty &tDirty) {
+	assert(pDst != nullptr);
+	assert(pSrcA != nullptr);
+	assert(pSrcB != nullptr);
+
+	int32_t nFirst = -1;
+	int32_t nLast = -1;
+	uint32_t i = 0;
+
+	for (; (i + sizeof(block_t)) <= nLength; i += sizeof(block_t)) {
+		const block_t data = Max(Load(&pSrcA[i]), Load(&pSrcB[i]));
+		Mark(Load(&pDst[i]), data, i, nFirst, nLast);
+		Store(&pDst[i], data);
+	}
+
+	for (; i < nLength; i++) {
+		const uint8_t data = pSrcA[i] > pSrcB[i] ? pSrcA[i] : pSrcB[i];
+		if (pDst[i] != data) {
+			if (nFirst < 0) {
+				nFirst = static_cast<int32_t>(i);
+			}
+			nLast = static_cast<int32_t>(i);
+			pDst[i] = data;
+		}
+	}
+
+	Result(nFirst, nLast, tDirty);
+	return nFirst >= 0;
+}
+
+bool MergeHtp(uint8_t *pDst, const uint8_t * const *pSrc, uint32_t nSources, uint32_t nLength, struct TLightSetDirty &tDirty) {
+	assert(pDst != nullptr);
+	assert(pSrc != nullptr);
+	assert(nSources != 0);
+
+	if (nSources == 1) {
+		return Copy(pDst, pSrc[0], nLength, tDirty);
+	}
+
+	if (nSources == 2) {
+		return MergeHtp(pDst, pSrc[0], pSrc[1], nLength, tDirty);
+	}
+
+	int32_t nFirst = -1;
+	int32_t nLast = -1;
+	uint32_t i = 0;
+
+	for (; (i + sizeof(block_t)) <= nLength; i += sizeof(block_t)) {
+		block_t data = Load(&pSrc[0][i]);
+
+		for (uint32_t nSource = 1; nSource < nSources; nSource++) {
+			data = Max(data, Load(&pSrc[nSource][i]));
+		}
+
+		Mark(Load(&pDst[i]), data, i, nFirst, nLast);
+		Store(&pDst[i], data);
+	}
+
+	for (; i < nLength; i++) {
+		uint8_t data = pSrc[0][i];
+
+		for (uint32_t nSource = 1; nSource < nSources; nSource++) {
+			if (pSrc[nSource][i] > data) {
+				data = pSrc[nSource][i];
+			}
+		}
+
+		if (pDst[i] != data) {
+			if (nFirst < 0) {
+				nFirst = static_cast<int32_t>(i);
+			}
+			nLast = static_cast<int32_t>(i);
+			pDst[i] = data;
+		}
+	}
+
+	Result(nFirst, nLast, tDirty);
+	return nFirst >= 0;
+}
+
+bool MergeHtpPriority(uint8_t *pDst, const uint8_t * const *pSrc, const uint8_t * const *pPriority, uint32_t nSources, uint32_t nLength, struct TLightSetDirty &tDirty) {
+	assert(pDst != nullptr);
+	assert(pSrc != nullptr);
+	assert(pPriority != nullptr);
+	assert(nSources != 0);
+
+	int32_t nFirst = -1;
+	int32_t nLast = -1;
+	uint32_t i = 0;
+
+	for (; (i + sizeof(block_t)) <= nLength; i += sizeof(block_t)) {
+		block_t priority = {};
+		block_t data = {};
+
+		for (uint32_t nSource = 0; nSource < nSources; nSource++) {
+			data = Arbitrate(priority, data, Load(&pPriority[nSource][i]), Load(&pSrc[nSource][i]));
+		}
+
+		Mark(Load(&pDst[i]), data, i, nFirst, nLast);
+		Store(&pDst[i], data);
+	}
+
+	for (; i < nLength; i++) {
+		uint8_t priority = 0;
+		uint8_t data = 0;
+
+		for (uint32_t nSource = 0; nSource < nSources; nSource++) {
+			const uint8_t p = pPriority[nSource][i];
+
+			if (p > priority) {
+				priority = p;
+				data = pSrc[nSource][i];
+			} else if ((p != 0) && (p == priority) && (pSrc[nSource][i] > data)) {
+				data = pSrc[nSource][i];
+			}
+		}
+
+		if (pDst[i] != data) {
+			if (nFirst < 0) {
+				nFirst = static_cast<int32_t>(i);
+			}
+			nLast = static_cast<int32_t>(i);
+			pDst[i] = data;
+		}
+	}
+
+	Result(nFirst, nLast, tDirty);
+	return nFirst >= 0;
+}
+
+}  // namespace data
+}  // namespace lightset
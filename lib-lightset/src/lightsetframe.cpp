@@ -0,0 +1,73 @@
+/**
+ * @file lightsetframe.cpp
+ *
+ */
+/* Copyright (C) 2020 by Arjan van Vught mailto:info@orangepi-dmx.nl
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include <stdint.h>
+#include <cassert>
+
+#include "lightsetframe.h"
+#include "lightset.h"
+
+void LightSetFrame::PortBegin(uint32_t nPortIndex, uint32_t nMillis) {
+	assert(nPortIndex < MAX_PORTS);
+
+	if ((m_nPortMaskReceived & (static_cast<uint64_t>(1) << nPortIndex)) != 0) {
+		Commit();
+	}
+
+	if (m_nPortMaskReceived == 0) {
+		m_nMillisFirst = nMillis;
+	}
+}
+
+void LightSetFrame::SetData(uint8_t nPortIndex, const uint8_t *pData, uint16_t nLength, const struct TLightSetDirty &tDirty) {
+	assert(m_pLightSet != nullptr);
+
+	if (!m_bIsUpdated) {
+		m_bIsUpdated = true;
+		m_pLightSet->FrameBegin();
+	}
+
+	m_pLightSet->SetDataRange(nPortIndex, pData, nLength, tDirty);
+}
+
+void LightSetFrame::PortEnd(uint32_t nPortIndex) {
+	assert(nPortIndex < MAX_PORTS);
+
+	m_nPortMaskReceived |= (static_cast<uint64_t>(1) << nPortIndex);
+
+	if ((m_nPortMaskReceived & m_nPortMask) == m_nPortMask) {
+		Commit();
+	}
+}
+
+void LightSetFrame::Commit() {
+	if (m_bIsUpdated) {
+		assert(m_pLightSet != nullptr);
+		m_pLightSet->FrameCommit();
+		m_bIsUpdated = false;
+	}
+
+	m_nPortMaskReceived = 0;
+}
@@ -0,0 +1,84 @@
+/**
+ * @file lightsetmergepool.cpp
+ *
+ */
+/* Copyright (C) 2020 by Arjan van Vught mailto:info@orangepi-dmx.nl
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include <stdint.h>
+#include <string.h>
+#include <cassert>
+
+#include "lightsetmergepool.h"
+#include "lightset.h"
+
+LightSetMergePool::~LightSetMergePool() {
+	delete[] m_ppFree;
+	m_ppFree = nullptr;
+
+	delete[] m_pBuffers;
+	m_pBuffers = nullptr;
+}
+
+void LightSetMergePool::Setup(uint32_t nBuffers) {
+	if (m_pBuffers != nullptr) {
+		return;
+	}
+
+	m_nBuffers = nBuffers;
+
+	if (nBuffers == 0) {
+		return;
+	}
+
+	m_pBuffers = new uint8_t[nBuffers * DMX_UNIVERSE_SIZE];
+	assert(m_pBuffers != nullptr);
+
+	m_ppFree = new uint8_t*[nBuffers];
+	assert(m_ppFree != nullptr);
+
+	for (uint32_t i = 0; i < nBuffers; i++) {
+		m_ppFree[i] = &m_pBuffers[i * DMX_UNIVERSE_SIZE];
+	}
+
+	m_nFree = nBuffers;
+}
+
+uint8_t *LightSetMergePool::Get() {
+	if (m_nFree == 0) {
+		m_nExhausted++;
+		return nullptr;
+	}
+
+	uint8_t *pBuffer = m_ppFree[--m_nFree];
+	memset(pBuffer, 0, DMX_UNIVERSE_SIZE);
+
+	return pBuffer;
+}
+
+void LightSetMergePool::Put(uint8_t *pBuffer) {
+	assert(pBuffer != nullptr);
+	assert(pBuffer >= m_pBuffers);
+	assert(pBuffer < &m_pBuffers[m_nBuffers * DMX_UNIVERSE_SIZE]);
+	assert(m_nFree < m_nBuffers);
+
+	m_ppFree[m_nFree++] = pBuffer;
+}
@@ -45,7 +45,8 @@ enum TNetwork {
 	NETWORK_IP_SIZE = 4,
 	NETWORK_MAC_SIZE = 6,
 	NETWORK_HOSTNAME_SIZE = 64,		/* including a terminating null byte. */
-	NETWORK_DOMAINNAME_SIZE = 64	/* including a terminating null byte. */
+	NETWORK_DOMAINNAME_SIZE = 64,	/* including a terminating null byte. */
+	NETWORK_UDP_DATA_SIZE = 1472	/* Ethernet MTU minus the IPv4 and UDP headers */
 };
 
 enum class DhcpClientStatus {
@@ -55,6 +56,26 @@ enum class DhcpClientStatus {
 	FAILED
 };
 
+struct TNetworkRecv {
+	void *pBuffer;
+	uint32_t nFromIp;
+	uint16_t nLength;	///< In: the size of pBuffer, out: the number of bytes received
+	uint16_t nFromPort;
+};
+
+struct TNetworkSend {
+	const void *pBuffer;
+	uint32_t nToIp;
+	uint16_t nLength;
+	uint16_t nRemotePort;
+};
+
+struct TNetworkQueueStats {
+	uint32_t nDepth;		///< The number of datagrams the receive queue can hold
+	uint32_t nHighWater;	///< The highest number of datagrams queued
+	uint32_t nDrops;		///< The number of datagrams dropped because the queue was full
+};
+
 class NetworkDisplay {
 public:
 	virtual ~NetworkDisplay() {
@@ -100,6 +121,38 @@ public:
 	virtual uint16_t RecvFrom(int32_t nHandle, void *pBuffer, uint16_t nLength, uint32_t *pFromIp, uint16_t *pFromPort)=0;
 	virtual void SendTo(int32_t nHandle, const void *pBuffer, uint16_t nLength, uint32_t nToIp, uint16_t nRemotePort)=0;
 
+	/**
+	 * Receives up to nCount datagrams, stops at the first empty receive.
+	 * The default is a RecvFrom loop.
+	 * @return the number of datagrams received
+	 */
+	virtual uint32_t RecvFromBatch(int32_t nHandle, struct TNetworkRecv *pRecv, uint32_t nCount);
+	/**
+	 * Sends nCount datagrams. The default is a SendTo loop.
+	 */
+	virtual void SendToBatch(int32_t nHandle, const struct TNetworkSend *pSend, uint32_t nCount);
+
+	/**
+	 * Zero-copy receive. *ppBuffer points to the received datagram, which can be parsed (and modified) in place.
+	 * It stays valid until Release(nHandle), which must be called before the next RecvLease or RecvFrom on nHandle.
+	 * The default copies into one internal buffer, shared by all the handles.
+	 * @return the length, 0 when nothing is received (there is nothing to release)
+	 */
+	virtual uint16_t RecvLease(int32_t nHandle, void **ppBuffer, uint32_t *pFromIp, uint16_t *pFromPort);
+	virtual void Release(__attribute__((unused)) int32_t nHandle) {
+	}
+
+	/**
+	 * Sets the receive queue depth of nHandle, in datagrams. Pending datagrams may be discarded.
+	 * @return false when not supported or out of queue memory (the previous depth is kept)
+	 */
+	virtual bool SetQueueDepth(__attribute__((unused)) int32_t nHandle, __attribute__((unused)) uint32_t nDepth) {
+		return false;
+	}
+	virtual bool GetQueueStats(__attribute__((unused)) int32_t nHandle, __attribute__((unused)) struct TNetworkQueueStats *pStats) {
+		return false;
+	}
+
 	virtual void SetIp(uint32_t nIp)=0;
 	virtual void SetNetmask(uint32_t nNetmask)=0;
 	virtual bool SetZeroconf()=0;
@@ -108,6 +161,12 @@ public:
 	virtual void SetHostName(const char *pHostName);
 	virtual void SetDomainName(const char *pDomainName);
 
+	/**
+	 * Moves a received frame into the UDP queues, for a polled network stack
+	 */
+	virtual void Run() {
+	}
+
 	uint32_t GetIp() const {
 		return m_nLocalIp;
 	}
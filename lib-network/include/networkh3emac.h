@@ -56,6 +56,14 @@ public:
 	uint16_t RecvFrom(int32_t nHandle, void *pBuffer, uint16_t nLength, uint32_t *pFromIp, uint16_t *pFromPort) override;
 	void SendTo(int32_t nHandle, const void *pBuffer, uint16_t nLength, uint32_t nToIp, uint16_t nRemotePort) override;
 
+	uint32_t RecvFromBatch(int32_t nHandle, struct TNetworkRecv *pRecv, uint32_t nCount) override;
+	void SendToBatch(int32_t nHandle, const struct TNetworkSend *pSend, uint32_t nCount) override;
+
+	uint16_t RecvLease(int32_t nHandle, void **ppBuffer, uint32_t *pFromIp, uint16_t *pFromPort) override;
+	void Release(int32_t nHandle) override;
+	bool SetQueueDepth(int32_t nHandle, uint32_t nDepth) override;
+	bool GetQueueStats(int32_t nHandle, struct TNetworkQueueStats *pStats) override;
+
 	void SetIp(uint32_t nIp) override;
 	void SetNetmask(uint32_t nNetmask) override;
 	void SetHostName(const char *pHostName) override;
@@ -63,7 +71,7 @@ public:
 
 	bool EnableDhcp() override; 
 
-	void Run() {
+	void Run() override {
 		net_handle();
 	}
 
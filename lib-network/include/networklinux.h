@@ -32,6 +32,8 @@
 
 class NetworkLinux: public Network {
 public:
+	static constexpr uint32_t WAIT_INFINITE = UINT32_MAX;
+
 	NetworkLinux();
 	~NetworkLinux();
 
@@ -59,6 +61,17 @@ public:
 	uint16_t RecvFrom(int32_t nHandle, void *pBuffer, uint16_t nLength, uint32_t *pFromIp, uint16_t *pFromPort);
 	void SendTo(int32_t nHandle, const void *pBuffer, uint16_t nLength, uint32_t nToIp, uint16_t nRemotePort);
 
+#if defined (__linux__)
+	uint32_t RecvFromBatch(int32_t nHandle, struct TNetworkRecv *pRecv, uint32_t nCount);
+	void SendToBatch(int32_t nHandle, const struct TNetworkSend *pSend, uint32_t nCount);
+#endif
+
+	/**
+	 * Blocks until one of the handles opened with Begin is readable, or nTimeoutMillis has expired.
+	 * @return the number of readable handles, 0 on timeout
+	 */
+	int32_t Wait(uint32_t nTimeoutMillis);
+
 private:
 	uint32_t GetDefaultGateway();
 	bool IsDhclient(const char *pIfName);
@@ -67,6 +80,10 @@ private:
 #if defined(__APPLE__)
 	bool OSxGetMacaddress(const char *pIfName, uint8_t *pMacAddress);
 #endif
+
+#if defined (__linux__)
+	int m_nEpollFd{-1};
+#endif
 };
 
 #endif /* NETWORKLINUX_H_ */
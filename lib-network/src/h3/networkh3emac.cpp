@@ -204,6 +204,51 @@ void NetworkH3emac::SendTo(int32_t nHandle, const void *pBuffer, uint16_t nLengt
 	udp_send(nHandle, reinterpret_cast<const uint8_t*>(pBuffer), nLength, to_ip, remote_port);
 }
 
+uint32_t NetworkH3emac::RecvFromBatch(int32_t nHandle, struct TNetworkRecv *pRecv, uint32_t nCount) {
+	uint32_t i;
+
+	for (i = 0; i < nCount; i++) {
+		pRecv[i].nLength = udp_recv(nHandle, reinterpret_cast<uint8_t*>(pRecv[i].pBuffer), pRecv[i].nLength, &pRecv[i].nFromIp, &pRecv[i].nFromPort);
+
+		if (pRecv[i].nLength == 0) {
+			break;
+		}
+	}
+
+	return i;
+}
+
+void NetworkH3emac::SendToBatch(int32_t nHandle, const struct TNetworkSend *pSend, uint32_t nCount) {
+	for (uint32_t i = 0; i < nCount; i++) {
+		udp_send(nHandle, reinterpret_cast<const uint8_t*>(pSend[i].pBuffer), pSend[i].nLength, pSend[i].nToIp, pSend[i].nRemotePort);
+	}
+}
+
+uint16_t NetworkH3emac::RecvLease(int32_t nHandle, void **ppBuffer, uint32_t *pFromIp, uint16_t *pFromPort) {
+	return udp_recv_lease(nHandle, reinterpret_cast<uint8_t**>(ppBuffer), pFromIp, pFromPort);
+}
+
+void NetworkH3emac::Release(int32_t nHandle) {
+	udp_release(nHandle);
+}
+
+bool NetworkH3emac::SetQueueDepth(int32_t nHandle, uint32_t nDepth) {
+	return udp_set_queue_depth(nHandle, nDepth) == 0;
+}
+
+bool NetworkH3emac::GetQueueStats(int32_t nHandle, struct TNetworkQueueStats *pStats) {
+	assert(pStats != nullptr);
+
+	struct udp_queue_stats stats;
+	udp_get_queue_stats(nHandle, &stats);
+
+	pStats->nDepth = stats.depth;
+	pStats->nHighWater = stats.high_water;
+	pStats->nDrops = stats.drops;
+
+	return true;
+}
+
 void NetworkH3emac::SetDefaultIp() {
 	DEBUG_ENTRY
 
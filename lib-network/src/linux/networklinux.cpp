@@ -32,8 +32,14 @@
 #include <sys/types.h>
 #include <net/if.h>
 #include <ifaddrs.h>
+#include <fcntl.h>
 #include <errno.h>
 #include <cassert>
+#if defined (__linux__)
+# include <sys/epoll.h>
+#else
+# include <poll.h>
+#endif
 
 #include "networklinux.h"
 
@@ -48,6 +54,7 @@ namespace max {
 	static constexpr auto PORTS_ALLOWED = 16;
 	static constexpr auto ENTRIES = (1 << 2); // Must always be a power of 2
 	static constexpr auto ENTRIES_MASK __attribute__((unused)) = (ENTRIES - 1);
+	static constexpr uint32_t BATCH = 64;	///< Datagrams per recvmmsg / sendmmsg
 }
 
 static int s_ports_allowed[max::PORTS_ALLOWED];
@@ -58,9 +65,18 @@ static int snHandles[max::PORTS_ALLOWED];
  */
 
 NetworkLinux::NetworkLinux() {
+#if defined (__linux__)
+	if ((m_nEpollFd = epoll_create1(EPOLL_CLOEXEC)) == -1) {
+		perror("epoll_create1");
+		exit(EXIT_FAILURE);
+	}
+#endif
 }
 
 NetworkLinux::~NetworkLinux() {
+#if defined (__linux__)
+	close(m_nEpollFd);
+#endif
 }
 
 int NetworkLinux::Init(const char *s) {
@@ -189,12 +205,9 @@ int32_t NetworkLinux::Begin(uint16_t nPort) {
 		exit(EXIT_FAILURE);
 	}
 
-	struct timeval recv_timeout;
-	recv_timeout.tv_sec = 0;
-	recv_timeout.tv_usec = 10;
-
-	if (setsockopt(nSocket, SOL_SOCKET, SO_RCVTIMEO, static_cast<void*>(&recv_timeout), sizeof(recv_timeout)) == -1) {
-		perror("setsockopt(SO_RCVTIMEO)");
+	// RecvFrom returns immediately, Wait blocks until there is something to receive
+	if (fcntl(nSocket, F_SETFL, fcntl(nSocket, F_GETFL, 0) | O_NONBLOCK) == -1) {
+		perror("fcntl(O_NONBLOCK)");
 		exit(EXIT_FAILURE);
 	}
 
@@ -210,6 +223,17 @@ int32_t NetworkLinux::Begin(uint16_t nPort) {
 		exit(EXIT_FAILURE);
 	}
 
+#if defined (__linux__)
+	struct epoll_event event;
+	event.events = EPOLLIN;
+	event.data.fd = nSocket;
+
+	if (epoll_ctl(m_nEpollFd, EPOLL_CTL_ADD, nSocket, &event) == -1) {
+		perror("epoll_ctl(EPOLL_CTL_ADD)");
+		exit(EXIT_FAILURE);
+	}
+#endif
+
 /**
  * BEGIN - needed H3 code compatibility
  */
@@ -250,6 +274,11 @@ int32_t NetworkLinux::End(uint16_t nPort) {
 		if (s_ports_allowed[i] == nPort) {
 			s_ports_allowed[i] = 0;
 			printf("close");
+#if defined (__linux__)
+			if (epoll_ctl(m_nEpollFd, EPOLL_CTL_DEL, snHandles[i], nullptr) == -1) {
+				perror("epoll_ctl(EPOLL_CTL_DEL)");
+			}
+#endif
 			if (close(snHandles[i]) == -1) {
 				perror("unbind");
 				exit(EXIT_FAILURE);
@@ -383,6 +412,115 @@ void NetworkLinux::SendTo(int32_t nHandle, const void *pPacket, uint16_t nSize,
 	}
 }
 
+#if defined (__linux__)
+uint32_t NetworkLinux::RecvFromBatch(int32_t nHandle, struct TNetworkRecv *pRecv, uint32_t nCount) {
+	assert(pRecv != nullptr);
+
+	struct mmsghdr msgs[max::BATCH];
+	struct iovec iovecs[max::BATCH];
+	struct sockaddr_in addrs[max::BATCH];
+
+	const uint32_t nBatch = (nCount < max::BATCH) ? nCount : max::BATCH;
+
+	for (uint32_t i = 0; i < nBatch; i++) {
+		iovecs[i].iov_base = pRecv[i].pBuffer;
+		iovecs[i].iov_len = pRecv[i].nLength;
+		memset(&msgs[i].msg_hdr, 0, sizeof(msgs[i].msg_hdr));
+		msgs[i].msg_hdr.msg_iov = &iovecs[i];
+		msgs[i].msg_hdr.msg_iovlen = 1;
+		msgs[i].msg_hdr.msg_name = &addrs[i];
+		msgs[i].msg_hdr.msg_namelen = sizeof(addrs[i]);
+	}
+
+	const int nReceived = recvmmsg(nHandle, msgs, nBatch, MSG_DONTWAIT, nullptr);
+
+	if (nReceived == -1) {
+		if ((errno != EAGAIN) && (errno != EWOULDBLOCK)) {
+			perror("recvmmsg");
+		}
+		return 0;
+	}
+
+	for (int i = 0; i < nReceived; i++) {
+		pRecv[i].nLength = static_cast<uint16_t>(msgs[i].msg_len);
+		pRecv[i].nFromIp = addrs[i].sin_addr.s_addr;
+		pRecv[i].nFromPort = ntohs(addrs[i].sin_port);
+	}
+
+	return static_cast<uint32_t>(nReceived);
+}
+
+void NetworkLinux::SendToBatch(int32_t nHandle, const struct TNetworkSend *pSend, uint32_t nCount) {
+	assert(pSend != nullptr);
+
+	struct mmsghdr msgs[max::BATCH];
+	struct iovec iovecs[max::BATCH];
+	struct sockaddr_in addrs[max::BATCH];
+
+	while (nCount != 0) {
+		const uint32_t nBatch = (nCount < max::BATCH) ? nCount : max::BATCH;
+
+		for (uint32_t i = 0; i < nBatch; i++) {
+			iovecs[i].iov_base = const_cast<void*>(pSend[i].pBuffer);
+			iovecs[i].iov_len = pSend[i].nLength;
+			memset(&addrs[i], 0, sizeof(addrs[i]));
+			addrs[i].sin_family = AF_INET;
+			addrs[i].sin_addr.s_addr = pSend[i].nToIp;
+			addrs[i].sin_port = htons(pSend[i].nRemotePort);
+			memset(&msgs[i].msg_hdr, 0, sizeof(msgs[i].msg_hdr));
+			msgs[i].msg_hdr.msg_iov = &iovecs[i];
+			msgs[i].msg_hdr.msg_iovlen = 1;
+			msgs[i].msg_hdr.msg_name = &addrs[i];
+			msgs[i].msg_hdr.msg_namelen = sizeof(addrs[i]);
+		}
+
+		int nSent = sendmmsg(nHandle, msgs, nBatch, 0);
+
+		if (nSent == -1) {
+			perror("sendmmsg");
+			// Skip the datagram that failed, as SendTo does
+			nSent = 1;
+		}
+
+		pSend += nSent;
+		nCount -= static_cast<uint32_t>(nSent);
+	}
+}
+#endif
+
+int32_t NetworkLinux::Wait(uint32_t nTimeoutMillis) {
+	const int nTimeout = (nTimeoutMillis > INT32_MAX) ? -1 : static_cast<int>(nTimeoutMillis);
+
+#if defined (__linux__)
+	struct epoll_event events[max::PORTS_ALLOWED];
+
+	const int nReady = epoll_wait(m_nEpollFd, events, max::PORTS_ALLOWED, nTimeout);
+#else
+	struct pollfd fds[max::PORTS_ALLOWED];
+	nfds_t nCount = 0;
+
+	for (uint32_t i = 0; i < max::PORTS_ALLOWED; i++) {
+		if (snHandles[i] != -1) {
+			fds[nCount].fd = snHandles[i];
+			fds[nCount].events = POLLIN;
+			fds[nCount].revents = 0;
+			nCount++;
+		}
+	}
+
+	const int nReady = poll(fds, nCount, nTimeout);
+#endif
+
+	if (nReady == -1) {
+		if (errno != EINTR) {
+			perror("Wait");
+		}
+		return 0;
+	}
+
+	return nReady;
+}
+
 #if defined(__linux__)
 bool NetworkLinux::IsDhclient(const char* if_name) {
 	char cmd[255];
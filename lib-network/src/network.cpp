@@ -33,6 +33,8 @@
 
 Network *Network::s_pThis = nullptr;
 
+static uint8_t s_LeaseBuffer[NETWORK_UDP_DATA_SIZE] __attribute__ ((aligned (4)));
+
 Network::Network() {
 	assert(s_pThis == nullptr);
 	s_pThis = this;
@@ -49,6 +51,38 @@ void Network::Shutdown() {
 	DEBUG_EXIT
 }
 
+uint32_t Network::RecvFromBatch(int32_t nHandle, struct TNetworkRecv *pRecv, uint32_t nCount) {
+	assert(pRecv != nullptr);
+
+	uint32_t i;
+
+	for (i = 0; i < nCount; i++) {
+		pRecv[i].nLength = RecvFrom(nHandle, pRecv[i].pBuffer, pRecv[i].nLength, &pRecv[i].nFromIp, &pRecv[i].nFromPort);
+
+		if (pRecv[i].nLength == 0) {
+			break;
+		}
+	}
+
+	return i;
+}
+
+void Network::SendToBatch(int32_t nHandle, const struct TNetworkSend *pSend, uint32_t nCount) {
+	assert(pSend != nullptr);
+
+	for (uint32_t i = 0; i < nCount; i++) {
+		SendTo(nHandle, pSend[i].pBuffer, pSend[i].nLength, pSend[i].nToIp, pSend[i].nRemotePort);
+	}
+}
+
+uint16_t Network::RecvLease(int32_t nHandle, void **ppBuffer, uint32_t *pFromIp, uint16_t *pFromPort) {
+	assert(ppBuffer != nullptr);
+
+	*ppBuffer = s_LeaseBuffer;
+
+	return RecvFrom(nHandle, s_LeaseBuffer, sizeof(s_LeaseBuffer), pFromIp, pFromPort);
+}
+
 void Network::SetQueuedStaticIp(uint32_t nLocalIp, uint32_t nNetmask) {
 	DEBUG_ENTRY
 	DEBUG_PRINTF(IPSTR ", nNetmask=" IPSTR, IP2STR(nLocalIp), IP2STR(nNetmask));
@@ -100,6 +100,7 @@ private:
 	bool m_bIsRunning{false};
 	char *m_pBuffer = nullptr;
 	uint8_t *m_pData = nullptr;
+	struct TLightSetDirty m_tDirty;
 	uint8_t *m_pOsc = nullptr;
 	char m_Os[32];
 	const char *m_pModel;
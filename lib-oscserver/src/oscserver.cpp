@@ -35,6 +35,7 @@
 #include "oscblob.h"
 
 #include "lightset.h"
+#include "lightsetdata.h"
 #include "network.h"
 
 #include "hardware.h"
@@ -74,6 +75,8 @@ OscServer::OscServer() {
 		m_pData[i] = 0;
 	}
 
+	lightset::data::SetAll(m_tDirty, DMX_UNIVERSE_SIZE);
+
 	m_pOsc  = new uint8_t[DMX_UNIVERSE_SIZE];
 	assert(m_pOsc != nullptr);
 
@@ -244,25 +247,21 @@ bool OscServer::IsDmxDataChanged(const uint8_t* pData, uint16_t nStartChannel, u
 	assert(pData != nullptr);
 	assert(nLength <= DMX_UNIVERSE_SIZE);
 
-	bool isChanged = false;
-
-	const uint8_t *src = pData;
-	uint8_t *dst = &m_pData[--nStartChannel];
+	--nStartChannel;
 
-	uint16_t nEnd = nStartChannel + nLength;
+	assert((nStartChannel + nLength) <= DMX_UNIVERSE_SIZE);
 
-	assert(nEnd <= DMX_UNIVERSE_SIZE);
+	struct TLightSetDirty tDirty;
 
-	for (uint32_t i = nStartChannel; i < nEnd; i++) {
-		if (*dst != *src) {
-			*dst = *src;
-			isChanged = true;
-		}
-		dst++;
-		src++;
+	if (!lightset::data::Copy(&m_pData[nStartChannel], pData, nLength, tDirty)) {
+		return false;
 	}
 
-	return isChanged;
+	tDirty.nFirst = static_cast<uint16_t>(tDirty.nFirst + nStartChannel);
+	tDirty.nLast = static_cast<uint16_t>(tDirty.nLast + nStartChannel);
+	lightset::data::Add(m_tDirty, tDirty);
+
+	return true;
 }
 
 void OscServer::Run() {
@@ -299,10 +298,12 @@ void OscServer::Run() {
 
 				if (bIsDmxDataChanged || m_bEnableNoChangeUpdate) {
 					if ((!m_bPartialTransmission) || (size == DMX_UNIVERSE_SIZE)) {
-						m_pLightSet->SetData(0, m_pData, DMX_UNIVERSE_SIZE);
+						m_pLightSet->SetDataRange(0, m_pData, DMX_UNIVERSE_SIZE, m_tDirty);
+						lightset::data::SetClean(m_tDirty);
 					} else {
 						m_nLastChannel = size > m_nLastChannel ? size : m_nLastChannel;
-						m_pLightSet->SetData(0, m_pData, m_nLastChannel);
+						m_pLightSet->SetDataRange(0, m_pData, m_nLastChannel, m_tDirty);
+						lightset::data::SetClean(m_tDirty);
 					}
 
 					if (!m_bIsRunning) {
@@ -340,10 +341,12 @@ void OscServer::Run() {
 
 			if (bIsDmxDataChanged || m_bEnableNoChangeUpdate) {
 				if (!m_bPartialTransmission) {
-					m_pLightSet->SetData(0, m_pData, DMX_UNIVERSE_SIZE);
+					m_pLightSet->SetDataRange(0, m_pData, DMX_UNIVERSE_SIZE, m_tDirty);
+					lightset::data::SetClean(m_tDirty);
 				} else {
 					m_nLastChannel = nChannel > m_nLastChannel ? nChannel : m_nLastChannel;
-					m_pLightSet->SetData(0, m_pData, m_nLastChannel);
+					m_pLightSet->SetDataRange(0, m_pData, m_nLastChannel, m_tDirty);
+					lightset::data::SetClean(m_tDirty);
 				}
 
 				if (!m_bIsRunning) {
@@ -381,10 +384,12 @@ void OscServer::Run() {
 
 				if (bIsDmxDataChanged || m_bEnableNoChangeUpdate) {
 					if (!m_bPartialTransmission) {
-						m_pLightSet->SetData(0, m_pData, DMX_UNIVERSE_SIZE);
+						m_pLightSet->SetDataRange(0, m_pData, DMX_UNIVERSE_SIZE, m_tDirty);
+						lightset::data::SetClean(m_tDirty);
 					} else {
 						m_nLastChannel = nChannel > m_nLastChannel ? nChannel : m_nLastChannel;
-						m_pLightSet->SetData(0, m_pData, m_nLastChannel);
+						m_pLightSet->SetDataRange(0, m_pData, m_nLastChannel, m_tDirty);
+						lightset::data::SetClean(m_tDirty);
 					}
 
 					if (!m_bIsRunning) {
@@ -41,6 +41,7 @@ public:
 	void Stop(uint8_t nPort = 0) override;
 
 	void SetData(uint8_t nPort, const uint8_t *pDmxData, uint16_t nLength) override;
+	void SetDataRange(uint8_t nPort, const uint8_t *pDmxData, uint16_t nLength, const struct TLightSetDirty &tDirty) override;
 
 public: // RDM
 	bool SetDmxStartAddress(uint16_t nDmxStartAddress) override;
@@ -96,7 +96,14 @@ void PCA9685DmxLed::Stop(__attribute__((unused)) uint8_t nPort) {
 	m_bIsStarted = false;
 }
 
-void PCA9685DmxLed::SetData(__attribute__((unused)) uint8_t nPort, const uint8_t *pDmxData, uint16_t nLength) {
+void PCA9685DmxLed::SetData(uint8_t nPort, const uint8_t *pDmxData, uint16_t nLength) {
+	struct TLightSetDirty tDirty;
+	lightset::data::SetAll(tDirty, nLength);
+
+	SetDataRange(nPort, pDmxData, nLength, tDirty);
+}
+
+void PCA9685DmxLed::SetDataRange(__attribute__((unused)) uint8_t nPort, const uint8_t *pDmxData, uint16_t nLength, const struct TLightSetDirty &tDirty) {
 	assert(pDmxData != nullptr);
 	assert(nLength <= DMX_MAX_CHANNELS);
 
@@ -104,28 +111,38 @@ void PCA9685DmxLed::SetData(__attribute__((unused)) uint8_t nPort, const uint8_t
 		Start();
 	}
 
-	uint8_t *p = const_cast<uint8_t*>(pDmxData) + m_nDmxStartAddress - 1;
-	uint8_t *q = m_pDmxData;
+	if (lightset::data::IsClean(tDirty)) {
+		return;
+	}
+
+	const uint32_t nOffset = static_cast<uint32_t>(m_nDmxStartAddress - 1);
+
+	uint32_t nSlotEnd = nOffset + m_nDmxFootprint;
+
+	if (nSlotEnd > nOffset + (m_nBoardInstances * PCA9685_PWM_CHANNELS)) {
+		nSlotEnd = nOffset + (m_nBoardInstances * PCA9685_PWM_CHANNELS);
+	}
+
+	if (nSlotEnd > nLength) {
+		nSlotEnd = nLength;
+	}
+
+	if (nSlotEnd > (tDirty.nLast + 1U)) {
+		nSlotEnd = tDirty.nLast + 1U;
+	}
 
-	uint16_t nChannel = m_nDmxStartAddress;
+	for (uint32_t nSlot = (tDirty.nFirst > nOffset ? tDirty.nFirst : nOffset); nSlot < nSlotEnd; nSlot++) {
+		const uint32_t k = nSlot - nOffset;
+		const uint32_t j = k / PCA9685_PWM_CHANNELS;
+		const uint32_t i = k % PCA9685_PWM_CHANNELS;
+		const uint8_t value = pDmxData[nSlot];
 
-	for (unsigned j = 0; j < m_nBoardInstances; j++) {
-		for (unsigned i = 0; i < PCA9685_PWM_CHANNELS; i++) {
-			if ((nChannel >= (m_nDmxFootprint + m_nDmxStartAddress)) || (nChannel > nLength)) {
-				j = m_nBoardInstances;
-				break;
-			}
-			if (*p != *q) {
-				uint8_t value = *p;
+		if (value != m_pDmxData[k]) {
 #ifndef NDEBUG
-				printf("m_pPWMLed[%d]->SetDmx(CHANNEL(%d), %d)\n", static_cast<int>(j), static_cast<int>(i), static_cast<int>(value));
+			printf("m_pPWMLed[%d]->SetDmx(CHANNEL(%d), %d)\n", static_cast<int>(j), static_cast<int>(i), static_cast<int>(value));
 #endif
-				m_pPWMLed[j]->Set(CHANNEL(i), value);
-			}
-			*q = *p;
-			p++;
-			q++;
-			nChannel++;
+			m_pPWMLed[j]->Set(CHANNEL(i), value);
+			m_pDmxData[k] = value;
 		}
 	}
 }
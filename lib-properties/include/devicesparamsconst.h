@@ -45,6 +45,16 @@ struct DevicesParamsConst {
 
 	static const char GLOBAL_BRIGHTNESS[];
 
+	static const char LED_GAMMA[];
+	static const char LED_BALANCE_RED[];
+	static const char LED_BALANCE_GREEN[];
+	static const char LED_BALANCE_BLUE[];
+	static const char LED_BALANCE_WHITE[];
+	static const char LED_DITHER[];
+
+	static const char LED_INTERPOLATION_HZ[];
+	static const char LED_INTERPOLATION_MS[];
+
 	static const char ACTIVE_OUT[];
 	static const char USE_SI5351A[];
 };
@@ -43,5 +43,15 @@ const char DevicesParamsConst::SPI_SPEED_HZ[] = "clock_speed_hz";
 
 const char DevicesParamsConst::GLOBAL_BRIGHTNESS[] = "global_brightness";
 
+const char DevicesParamsConst::LED_GAMMA[] = "led_gamma";
+const char DevicesParamsConst::LED_BALANCE_RED[] = "led_balance_red";
+const char DevicesParamsConst::LED_BALANCE_GREEN[] = "led_balance_green";
+const char DevicesParamsConst::LED_BALANCE_BLUE[] = "led_balance_blue";
+const char DevicesParamsConst::LED_BALANCE_WHITE[] = "led_balance_white";
+const char DevicesParamsConst::LED_DITHER[] = "led_dither";
+
+const char DevicesParamsConst::LED_INTERPOLATION_HZ[] = "led_interpolation_hz";
+const char DevicesParamsConst::LED_INTERPOLATION_MS[] = "led_interpolation_ms";
+
 const char DevicesParamsConst::ACTIVE_OUT[] = "active_out";
 const char DevicesParamsConst::USE_SI5351A[] = "use_si5351A";
@@ -82,7 +82,14 @@ void TLC59711Dmx::Stop(__attribute__((unused)) uint8_t nPort) {
 	m_bIsStarted = false;
 }
 
-void TLC59711Dmx::SetData(__attribute__((unused)) uint8_t nPort, const uint8_t* pDmxData, uint16_t nLength) {
+void TLC59711Dmx::SetData(uint8_t nPort, const uint8_t* pDmxData, uint16_t nLength) {
+	struct TLightSetDirty tDirty;
+	lightset::data::SetAll(tDirty, nLength);
+
+	SetDataRange(nPort, pDmxData, nLength, tDirty);
+}
+
+void TLC59711Dmx::SetDataRange(__attribute__((unused)) uint8_t nPort, const uint8_t* pDmxData, uint16_t nLength, const struct TLightSetDirty &tDirty) {
 	assert(pDmxData != nullptr);
 	assert(nLength <= DMX_UNIVERSE_SIZE);
 
@@ -90,27 +97,34 @@ void TLC59711Dmx::SetData(__attribute__((unused)) uint8_t nPort, const uint8_t*
 		Start();
 	}
 
-	uint8_t *p = const_cast<uint8_t*>(pDmxData) + m_nDmxStartAddress - 1;
+	if (lightset::data::IsClean(tDirty)) {
+		return;
+	}
 
-	unsigned nDmxAddress = m_nDmxStartAddress;
+	const uint32_t nOffset = static_cast<uint32_t>(m_nDmxStartAddress - 1);
 
-	for (unsigned i = 0; i < m_nDmxFootprint; i++) {
-		if (nDmxAddress > nLength) {
-			break;
-		}
+	uint32_t nSlotEnd = nOffset + m_nDmxFootprint;
 
-		const uint16_t nValue = (static_cast<uint16_t>(*p) << 8) | static_cast<uint16_t>(*p);
-
-		m_pTLC59711->Set(i, nValue);
+	if (nSlotEnd > nLength) {
+		nSlotEnd = nLength;
+	}
 
-		p++;
-		nDmxAddress++;
+	if (nSlotEnd > (tDirty.nLast + 1U)) {
+		nSlotEnd = tDirty.nLast + 1U;
 	}
 
-	if (__builtin_expect((nDmxAddress == m_nDmxStartAddress), 0)) {
+	uint32_t nSlot = tDirty.nFirst > nOffset ? tDirty.nFirst : nOffset;
+
+	if (nSlot >= nSlotEnd) {
 		return;
 	}
 
+	for (; nSlot < nSlotEnd; nSlot++) {
+		const uint16_t nValue = (static_cast<uint16_t>(pDmxData[nSlot]) << 8) | static_cast<uint16_t>(pDmxData[nSlot]);
+
+		m_pTLC59711->Set(nSlot - nOffset, nValue);
+	}
+
 	if (!m_bBlackout) {
 		m_pTLC59711->Update();
 	}
@@ -24,6 +24,8 @@
 #ifndef RGBMAPPING_H_
 #define RGBMAPPING_H_
 
+#include <stdint.h>
+
 enum TRGBMapping {
 	RGB_MAPPING_RGB,
 	RGB_MAPPING_RBG,
@@ -34,6 +36,19 @@ enum TRGBMapping {
 	RGB_MAPPING_UNDEFINED
 };
 
+namespace rgbmapping {
+/**
+ * Wire position (0, 1, 2) of the red, green and blue component
+ */
+template<TRGBMapping tRGBMapping> struct Order;
+template<> struct Order<RGB_MAPPING_RGB> { static constexpr uint32_t R = 0, G = 1, B = 2; };
+template<> struct Order<RGB_MAPPING_RBG> { static constexpr uint32_t R = 0, G = 2, B = 1; };
+template<> struct Order<RGB_MAPPING_GRB> { static constexpr uint32_t R = 1, G = 0, B = 2; };
+template<> struct Order<RGB_MAPPING_GBR> { static constexpr uint32_t R = 2, G = 0, B = 1; };
+template<> struct Order<RGB_MAPPING_BRG> { static constexpr uint32_t R = 1, G = 2, B = 0; };
+template<> struct Order<RGB_MAPPING_BGR> { static constexpr uint32_t R = 2, G = 1, B = 0; };
+}  // namespace rgbmapping
+
 class RGBMapping {
 public:
 	static TRGBMapping FromString(const char *pString);
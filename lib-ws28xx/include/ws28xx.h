@@ -27,6 +27,7 @@
 #define WS28XX_H_
 
 #include <stdint.h>
+#include <cassert>
 
 #include "rgbmapping.h"
 
@@ -48,7 +49,15 @@ enum TWS28XXType {
 };
 
 enum {
-	LEDCOUNT_RGB_MAX = (4 * 170), LEDCOUNT_RGBW_MAX = (4 * 128)
+	LEDCOUNT_RGB_UNIVERSE = 170, LEDCOUNT_RGBW_UNIVERSE = 128
+};
+
+/*
+ * A LED takes 30us (RGB) or 40us (RGBW) on the 800kHz wire, the frame rate is bound by the LED count:
+ *   680 LEDs (4 universes) ~ 48 fps, 1360 (8) ~ 24 fps, 2720 (16) ~ 12 fps, 5440 (32) ~ 6 fps
+ */
+enum {
+	LEDCOUNT_RGB_MAX = (32 * LEDCOUNT_RGB_UNIVERSE), LEDCOUNT_RGBW_MAX = (32 * LEDCOUNT_RGBW_UNIVERSE)
 };
 
 enum {
@@ -105,9 +114,25 @@ public:
 		return m_nGlobalBrightness;
 	}
 
-	void SetLED(uint32_t nLEDIndex, uint8_t nRed, uint8_t nGreen, uint8_t nBlue);
+	void SetLED(uint32_t nLEDIndex, uint8_t nRed, uint8_t nGreen, uint8_t nBlue) {
+		assert(m_pBuffer != nullptr);
+		assert(nLEDIndex < m_nLedCount);
+		(this->*m_pSetLED)(nLEDIndex, nRed, nGreen, nBlue);
+	}
 	void SetLED(uint32_t nLEDIndex, uint8_t nRed, uint8_t nGreen, uint8_t nBlue, uint8_t nWhite);
 
+	/**
+	 * Encodes nCount pixels of 3 slots (4 slots for SK6812W) starting with LED nFirstLed.
+	 * Each pixel is set on nGroupCount consecutive LEDs.
+	 */
+	void SetLEDs(uint32_t nFirstLed, const uint8_t *pData, uint32_t nCount, uint32_t nGroupCount = 1) {
+		assert(m_pBuffer != nullptr);
+		assert(pData != nullptr);
+		assert(nGroupCount != 0);
+		assert(nFirstLed + (nCount * nGroupCount) <= m_nLedCount);
+		(this->*m_pSetLEDs)(nFirstLed, pData, nCount, nGroupCount);
+	}
+
 	void Update();
 	void Blackout();
 
@@ -123,7 +148,21 @@ public:
 	static uint8_t ConvertTxH(float fTxH);
 
 private:
+	void SetupRTZTable();
+	void SetupEncoder();
 	void SetColorWS28xx(uint32_t nOffset, uint8_t nValue);
+	/*
+	 * The encoders, one is selected in the constructor
+	 */
+	template<TRGBMapping tRGBMapping>
+	void SetLEDRTZ(uint32_t nLEDIndex, uint8_t nRed, uint8_t nGreen, uint8_t nBlue);
+	void SetLEDAPA102(uint32_t nLEDIndex, uint8_t nRed, uint8_t nGreen, uint8_t nBlue);
+	void SetLEDWS2801(uint32_t nLEDIndex, uint8_t nRed, uint8_t nGreen, uint8_t nBlue);
+	void SetLEDP9813(uint32_t nLEDIndex, uint8_t nRed, uint8_t nGreen, uint8_t nBlue);
+	template<TRGBMapping tRGBMapping>
+	void SetLEDsRTZ(uint32_t nFirstLed, const uint8_t *pData, uint32_t nCount, uint32_t nGroupCount);
+	void SetLEDsRTZW(uint32_t nFirstLed, const uint8_t *pData, uint32_t nCount, uint32_t nGroupCount);
+	void SetLEDsSPI(uint32_t nFirstLed, const uint8_t *pData, uint32_t nCount, uint32_t nGroupCount);
 
 protected:
 	TWS28XXType m_tLEDType;
@@ -138,6 +177,13 @@ protected:
 
 	alignas(uintptr_t) uint8_t *m_pBuffer;
 	alignas(uintptr_t) uint8_t *m_pBlackoutBuffer;
+
+private:
+	typedef void (WS28xx::*SetLEDFunction)(uint32_t, uint8_t, uint8_t, uint8_t);
+	SetLEDFunction m_pSetLED;
+	typedef void (WS28xx::*SetLEDsFunction)(uint32_t, const uint8_t *, uint32_t, uint32_t);
+	SetLEDsFunction m_pSetLEDs;
+	uint64_t m_aRTZTable[256];	///< The 8 RTZ bytes (m_nLowCode / m_nHighCode) for each colour value, MSB first
 };
 
 #endif /* WS28XX_H_ */
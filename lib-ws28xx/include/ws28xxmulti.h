@@ -27,6 +27,7 @@
 #define WS28XXMULTI_H_
 
 #include <stdint.h>
+#include <cassert>
 
 #include "ws28xx.h"
 
@@ -78,11 +79,8 @@ public:
 	}
 
 	void SetLED(uint8_t nPort, uint16_t nLedIndex, uint8_t nRed, uint8_t nGreen, uint8_t nBlue) {
-		if (m_tBoard == WS28XXMULTI_BOARD_8X) {
-			SetLED8x(nPort, nLedIndex, nRed, nGreen, nBlue);
-		} else {
-			SetLED4x(nPort, nLedIndex, nRed, nGreen, nBlue);
-		}
+		assert(m_pSetLED != nullptr);
+		(this->*m_pSetLED)(nPort, nLedIndex, nRed, nGreen, nBlue);
 	}
 	void SetLED(uint8_t nPort, uint16_t nLedIndex, uint8_t nRed, uint8_t nGreen, uint8_t nBlue, uint8_t nWhite) {
 		if (m_tBoard == WS28XXMULTI_BOARD_8X) {
@@ -92,6 +90,18 @@ public:
 		}
 	}
 
+	/**
+	 * Encodes nCount pixels of 3 slots (4 slots for SK6812W) on output nPort, starting with LED nFirstLed.
+	 * Each pixel is set on nGroupCount consecutive LEDs.
+	 */
+	void SetLEDs(uint8_t nPort, uint32_t nFirstLed, const uint8_t *pData, uint32_t nCount, uint32_t nGroupCount = 1) {
+		assert(m_pSetLEDs != nullptr);
+		assert(pData != nullptr);
+		assert(nGroupCount != 0);
+		assert(nFirstLed + (nCount * nGroupCount) <= m_nLedCount);
+		(this->*m_pSetLEDs)(nPort, nFirstLed, pData, nCount, nGroupCount);
+	}
+
 #if defined (H3)
 	bool IsUpdating() {
 		if (m_tBoard == WS28XXMULTI_BOARD_8X) {
@@ -109,6 +119,26 @@ public:
 	void Update();
 	void Blackout();
 
+	/**
+	 * Starts the pending frame when the previous one has left the wire, never waits.
+	 */
+	void Run() {
+		if (m_bIsPending && !IsUpdating()) {
+			Update();
+		}
+	}
+
+	bool IsPending() const {
+		return m_bIsPending;
+	}
+
+	/**
+	 * Frames that have been overwritten by a newer frame before they could be sent.
+	 */
+	uint32_t GetFramesDropped() const {
+		return m_nFramesDropped;
+	}
+
 private:
 	uint8_t ReverseBits(uint8_t nBits);
 
@@ -118,15 +148,34 @@ private:
 	bool SetupSI5351A();
 	void SetupGPIO();
 	void SetupBuffers4x();
+	void SetupEncoder4x();
 	void Generate800kHz(const uint32_t *pBuffer);
+	template<TRGBMapping tRGBMapping>
 	void SetLED4x(uint8_t nPort, uint16_t nLedIndex, uint8_t nRed, uint8_t nGreen, uint8_t nBlue);
 	void SetLED4x(uint8_t nPort, uint16_t nLedIndex, uint8_t nRed, uint8_t nGreen, uint8_t nBlue, uint8_t nWhite);
+	template<TRGBMapping tRGBMapping>
+	void SetLEDs4x(uint8_t nPort, uint32_t nFirstLed, const uint8_t *pData, uint32_t nCount, uint32_t nGroupCount);
+	void SetLEDsRGBW4x(uint8_t nPort, uint32_t nFirstLed, const uint8_t *pData, uint32_t nCount, uint32_t nGroupCount);
 // 8x
 	void SetupHC595(uint8_t nT0H, uint8_t nT1H);
 	void SetupSPI();
 	void SetupBuffers8x();
+	void SetupEncoder8x();
+	void Encode8x();
+	void SetPixelsDirty8x(uint32_t nFirst, uint32_t nLast) {
+		if (nFirst < m_nPixelsFirst8x) {
+			m_nPixelsFirst8x = nFirst;
+		}
+		if (nLast > m_nPixelsLast8x) {
+			m_nPixelsLast8x = nLast;
+		}
+	}
+	template<TRGBMapping tRGBMapping>
 	void SetLED8x(uint8_t nPort, uint16_t nLedIndex, uint8_t nRed, uint8_t nGreen, uint8_t nBlue);
 	void SetLED8x(uint8_t nPort, uint16_t nLedIndex, uint8_t nRed, uint8_t nGreen, uint8_t nBlue, uint8_t nWhite);
+	template<TRGBMapping tRGBMapping>
+	void SetLEDs8x(uint8_t nPort, uint32_t nFirstLed, const uint8_t *pData, uint32_t nCount, uint32_t nGroupCount);
+	void SetLEDsRGBW8x(uint8_t nPort, uint32_t nFirstLed, const uint8_t *pData, uint32_t nCount, uint32_t nGroupCount);
 
 private:
 	WS28xxMultiBoard m_tBoard;
@@ -139,8 +188,18 @@ private:
 	uint32_t *m_pBuffer4x;
 	uint32_t *m_pBlackoutBuffer4x;
 
-	alignas(uintptr_t) uint8_t *m_pBuffer8x;
-	alignas(uintptr_t) uint8_t *m_pBlackoutBuffer8x;
+	alignas(uintptr_t) uint8_t *m_pBuffer8x;			///< Encoded frame, drained by the DMA
+	uint8_t *m_pPixels8x{nullptr};						///< Back buffer, per slot (colour of a LED) the 8 port values
+	uint32_t m_nPixelsFirst8x{UINT32_MAX};				///< Slots changed since the last Encode8x
+	uint32_t m_nPixelsLast8x{0};
+
+	typedef void (WS28xxMulti::*SetLEDFunction)(uint8_t, uint16_t, uint8_t, uint8_t, uint8_t);
+	SetLEDFunction m_pSetLED{nullptr};	///< Board x RGB mapping encoder, selected in Initialize
+	typedef void (WS28xxMulti::*SetLEDsFunction)(uint8_t, uint32_t, const uint8_t *, uint32_t, uint32_t);
+	SetLEDsFunction m_pSetLEDs{nullptr};
+
+	bool m_bIsPending{false};
+	uint32_t m_nFramesDropped{0};
 };
 
 #endif /* WS28XXMULTI_H_ */
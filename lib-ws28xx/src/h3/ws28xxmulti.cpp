@@ -24,6 +24,7 @@
  */
 
 #include <stdint.h>
+#include <string.h>
 #include <cassert>
 
 #include "ws28xxmulti.h"
@@ -42,7 +43,22 @@ uint8_t WS28xxMulti::ReverseBits(uint8_t nBits) {
 void WS28xxMulti::Update() {
 	if (m_tBoard == WS28XXMULTI_BOARD_8X) {
 		assert(m_pBuffer8x != nullptr);
-		assert(!h3_spi_dma_tx_is_active());
+
+		if (h3_spi_dma_tx_is_active()) {
+			// The previous frame is still on the wire, Run() sends this one
+			if (m_bIsPending) {
+				m_nFramesDropped++;
+			}
+			m_bIsPending = true;
+			return;
+		}
+
+		/*
+		 * The pixels are kept in the back buffer, the changed slots
+		 * are transposed into the DMA buffer now it is idle.
+		 */
+		Encode8x();
+		m_bIsPending = false;
 
 		h3_spi_dma_tx_start(m_pBuffer8x, m_nBufSize);
 	} else {
@@ -55,10 +71,18 @@ void WS28xxMulti::Blackout() {
 	DEBUG_ENTRY
 
 	if (m_tBoard == WS28XXMULTI_BOARD_8X) {
-		assert(m_pBlackoutBuffer8x != nullptr);
+		assert(m_pBuffer8x != nullptr);
 		assert(!h3_spi_dma_tx_is_active());
 
-		h3_spi_dma_tx_start(m_pBlackoutBuffer8x, m_nBufSize);
+		m_bIsPending = false;
+
+		/*
+		 * The back buffer keeps the pixels, the next Update encodes all slots again.
+		 */
+		memset(m_pBuffer8x, 0, m_nBufSize);
+		SetPixelsDirty8x(0, (m_nBufSize - 1) / 8 - 1);
+
+		h3_spi_dma_tx_start(m_pBuffer8x, m_nBufSize);
 	} else {
 		Generate800kHz(m_pBlackoutBuffer4x);
 	}
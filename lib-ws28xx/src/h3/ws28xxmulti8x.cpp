@@ -42,19 +42,19 @@ void WS28xxMulti::SetupBuffers8x(void) {
 	m_pBuffer8x = const_cast<uint8_t*>(h3_spi_dma_tx_prepare(&nSize));
 	assert(m_pBuffer8x != 0);
 
-	const uint32_t nSizeHalf = nSize / 2;
-	assert(m_nBufSize <= nSizeHalf);
-
-	if (m_nBufSize > nSizeHalf) {
-		// FIXME Handle internal error
-		return;
+	/*
+	 * There is no blackout copy, the whole DMA buffer is available for the frame.
+	 * A LED count not fitting is reduced.
+	 */
+	if (m_nBufSize > nSize) {
+		const uint32_t nBytesPerLed = (m_tWS28xxType == SK6812W) ? SINGLE_RGBW : SINGLE_RGB;
+
+		m_nLedCount = static_cast<uint16_t>((nSize - 1) / nBytesPerLed);
+		m_nBufSize = (m_nLedCount * nBytesPerLed) + 1;
 	}
 
-	m_pBlackoutBuffer8x = m_pBuffer8x + (nSizeHalf & static_cast<uint32_t>(~3));
-
 	memset(m_pBuffer8x, 0, m_nBufSize);
-	memcpy(m_pBlackoutBuffer8x, m_pBuffer8x, m_nBufSize);
 
-	DEBUG_PRINTF("nSize=%x, m_pBuffer=%p, m_pBlackoutBuffer=%p", nSize, m_pBuffer8x, m_pBlackoutBuffer8x);
+	DEBUG_PRINTF("nSize=%x, m_pBuffer=%p, m_nLedCount=%d", nSize, m_pBuffer8x, m_nLedCount);
 	DEBUG_EXIT
 }
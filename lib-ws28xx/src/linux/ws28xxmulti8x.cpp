@@ -34,24 +34,11 @@
 void WS28xxMulti::SetupBuffers8x(void) {
 	DEBUG_ENTRY
 
-	constexpr uint32_t nSize = 32 * 1024;
-
-	m_pBuffer8x = new uint8_t[nSize];
+	m_pBuffer8x = new uint8_t[m_nBufSize];
 	assert(m_pBuffer8x != 0);
 
-	const uint32_t nSizeHalf = nSize / 2;
-	assert(m_nBufSize <= nSizeHalf);
-
-	if (m_nBufSize > nSizeHalf) {
-		// FIXME Handle internal error
-		return;
-	}
-
-	m_pBlackoutBuffer8x = m_pBuffer8x + (nSizeHalf & static_cast<uint32_t>(~3));
-
 	memset(m_pBuffer8x, 0, m_nBufSize);
-	memcpy(m_pBlackoutBuffer8x, m_pBuffer8x, m_nBufSize);
 
-	DEBUG_PRINTF("nSize=%x, m_pBuffer=%p, m_pBlackoutBuffer=%p", nSize, m_pBuffer8x, m_pBlackoutBuffer8x);
+	DEBUG_PRINTF("m_nBufSize=%d, m_pBuffer=%p", m_nBufSize, m_pBuffer8x);
 	DEBUG_EXIT
 }
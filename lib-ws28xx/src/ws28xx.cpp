@@ -45,7 +45,9 @@ WS28xx::WS28xx(TWS28XXType Type, uint16_t nLedCount, TRGBMapping tRGBMapping, ui
 	m_nLowCode(nT0H),
 	m_nHighCode(nT1H),
 	m_pBuffer(0),
-	m_pBlackoutBuffer(0)
+	m_pBlackoutBuffer(0),
+	m_pSetLED(nullptr),
+	m_pSetLEDs(nullptr)
 {
 	assert(m_nLedCount != 0);
 
@@ -97,10 +99,14 @@ WS28xx::WS28xx(TWS28XXType Type, uint16_t nLedCount, TRGBMapping tRGBMapping, ui
 			m_nHighCode = nHighCode;
 		}
 
+		SetupRTZTable();
+
 		DEBUG_PRINTF("m_tWS28xxType=%d (%s), m_nLedCount=%d, m_nBufSize=%d", m_tLEDType, WS28xx::GetLedTypeString(m_tLEDType), m_nLedCount, m_nBufSize);
 		DEBUG_PRINTF("m_tRGBMapping=%d (%s), m_nLowCode=0x%X, m_nHighCode=0x%X", static_cast<int>(m_tRGBMapping), RGBMapping::ToString(m_tRGBMapping), static_cast<int>(m_nLowCode), static_cast<int>(m_nHighCode));
 	}
 
+	SetupEncoder();
+
 	FUNC_PREFIX (spi_begin());
 
 	if (m_bIsRTZProtocol) {
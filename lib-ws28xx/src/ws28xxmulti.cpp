@@ -46,8 +46,7 @@ WS28xxMulti::WS28xxMulti():
 	m_nBufSize(0),
 	m_pBuffer4x(nullptr),
 	m_pBlackoutBuffer4x(nullptr),
-	m_pBuffer8x(nullptr),
-	m_pBlackoutBuffer8x(nullptr)
+	m_pBuffer8x(nullptr)
 {
 	DEBUG_ENTRY
 
@@ -65,7 +64,9 @@ WS28xxMulti::~WS28xxMulti() {
 		delete[] m_pBuffer4x;
 		m_pBuffer4x = nullptr;
 	} else {
-		m_pBlackoutBuffer8x = nullptr;
+		delete[] m_pPixels8x;
+		m_pPixels8x = nullptr;
+
 		m_pBuffer8x = nullptr;
 	}
 }
@@ -103,10 +104,10 @@ void WS28xxMulti::Initialize(TWS28XXType tWS28xxType, uint16_t nLedCount, __attr
 
 	if (m_tWS28xxType == SK6812W) {
 		m_nLedCount = nLedCount <= static_cast<uint16_t>(LEDCOUNT_RGBW_MAX) ? nLedCount : static_cast<uint16_t>(LEDCOUNT_RGBW_MAX);
-		m_nBufSize = static_cast<uint32_t>(nLedCount * SINGLE_RGBW);
+		m_nBufSize = static_cast<uint32_t>(m_nLedCount * SINGLE_RGBW);
 	} else {
 		m_nLedCount = nLedCount <= static_cast<uint16_t>(LEDCOUNT_RGB_MAX) ? nLedCount : static_cast<uint16_t>(LEDCOUNT_RGB_MAX);
-		m_nBufSize = static_cast<uint32_t>(nLedCount * SINGLE_RGB);
+		m_nBufSize = static_cast<uint32_t>(m_nLedCount * SINGLE_RGB);
 	}
 
 	DEBUG_PRINTF("m_tWS28xxType=%d (%s), m_nLedCount=%d, m_nBufSize=%d", m_tWS28xxType, WS28xx::GetLedTypeString(m_tWS28xxType), m_nLedCount, m_nBufSize);
@@ -119,11 +120,13 @@ void WS28xxMulti::Initialize(TWS28XXType tWS28xxType, uint16_t nLedCount, __attr
 		}
 		SetupGPIO();
 		SetupBuffers4x();
+		SetupEncoder4x();
 	} else {
 		SetupHC595(ReverseBits(m_nLowCode), ReverseBits(m_nHighCode));
 		SetupSPI();
 		m_nBufSize++;
 		SetupBuffers8x();
+		SetupEncoder8x();
 	}
 
 	DEBUG_PRINTF("m_nLedCount=%d, m_nBufSize=%d", m_nLedCount,m_nBufSize);
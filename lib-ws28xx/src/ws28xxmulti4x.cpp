@@ -85,137 +85,112 @@ bool WS28xxMulti::SetupMCP23017(uint8_t nT0H, uint8_t nT1H) {
 #define BIT_SET(a,b) 	((a) |= (1U<<(b)))
 #define BIT_CLEAR(a,b) 	((a) &= ~(1U<<(b)))
 
+/*
+ * Replaces the port bit in the 8 slots, MSB first, without branching on the colour value
+ */
+static void SetColour(uint32_t *pBuffer, uint32_t nPort, uint8_t nValue) {
+	const uint32_t nMask = (~(1U << nPort));
+
+	for (uint32_t j = 0; j < 8; j++) {
+		const uint32_t nBit = (static_cast<uint32_t>(nValue) >> (7 - j)) & 0x1;
+		pBuffer[j] = ((pBuffer[j] & nMask) | (nBit << nPort));
+	}
+}
+
+/**
+ * The bit of nPort of the LED at pBuffer is replicated to the next nCopies - 1 LEDs
+ */
+static void Replicate(uint32_t *pBuffer, uint32_t nPort, uint32_t nLedSize, uint32_t nCopies) {
+	const uint32_t nBit = 1U << nPort;
+	uint32_t *pCopy = &pBuffer[nLedSize];
+
+	for (uint32_t k = 1; k < nCopies; k++) {
+		for (uint32_t j = 0; j < nLedSize; j++) {
+			pCopy[j] = (pCopy[j] & ~nBit) | (pBuffer[j] & nBit);
+		}
+		pCopy += nLedSize;
+	}
+}
+
+template<TRGBMapping tRGBMapping>
 void WS28xxMulti::SetLED4x(uint8_t nPort, uint16_t nLedIndex, uint8_t nRed, uint8_t nGreen, uint8_t nBlue) {
 	assert(nPort < 4);
 	assert(nLedIndex < m_nLedCount);
 
-	uint32_t j = 0;
-	uint32_t k = static_cast<uint32_t>(nLedIndex * SINGLE_RGB);
+	uint32_t *pBuffer = &m_pBuffer4x[static_cast<uint32_t>(nLedIndex * SINGLE_RGB)];
 
-	for (uint8_t mask = 0x80; mask != 0; mask >>= 1) {
-		switch (m_tRGBMapping) {
-		case RGB_MAPPING_RGB:
-			if (mask & nRed) {
-				BIT_SET(m_pBuffer4x[k + j], nPort);
-			} else {
-				BIT_CLEAR(m_pBuffer4x[k + j], nPort);
-			}
-			if (mask & nGreen) {
-				BIT_SET(m_pBuffer4x[8 + k + j], nPort);
-			} else {
-				BIT_CLEAR(m_pBuffer4x[8 + k + j], nPort);
-			}
-			if (mask & nBlue) {
-				BIT_SET(m_pBuffer4x[16 + k + j], nPort);
-			} else {
-				BIT_CLEAR(m_pBuffer4x[16 + k + j], nPort);
-			}
-			break;
-		case RGB_MAPPING_RBG:
-			if (mask & nRed) {
-				BIT_SET(m_pBuffer4x[k + j], nPort);
-			} else {
-				BIT_CLEAR(m_pBuffer4x[k + j], nPort);
-			}
-			if (mask & nBlue) {
-				BIT_SET(m_pBuffer4x[16 + k + j], nPort);
-			} else {
-				BIT_CLEAR(m_pBuffer4x[16 + k + j], nPort);
-			}
-			if (mask & nGreen) {
-				BIT_SET(m_pBuffer4x[8 + k + j], nPort);
-			} else {
-				BIT_CLEAR(m_pBuffer4x[8 + k + j], nPort);
-			}
-			break;
-		case RGB_MAPPING_GRB:
-			if (mask & nGreen) {
-				BIT_SET(m_pBuffer4x[k + j], nPort);
-			} else {
-				BIT_CLEAR(m_pBuffer4x[k + j], nPort);
-			}
-			if (mask & nRed) {
-				BIT_SET(m_pBuffer4x[8 + k + j], nPort);
-			} else {
-				BIT_CLEAR(m_pBuffer4x[8 + k + j], nPort);
-			}
-			if (mask & nBlue) {
-				BIT_SET(m_pBuffer4x[16 + k + j], nPort);
-			} else {
-				BIT_CLEAR(m_pBuffer4x[16 + k + j], nPort);
-			}
-			break;
-		case RGB_MAPPING_GBR:
-			if (mask & nGreen) {
-				BIT_SET(m_pBuffer4x[k + j], nPort);
-			} else {
-				BIT_CLEAR(m_pBuffer4x[k + j], nPort);
-			}
-			if (mask & nBlue) {
-				BIT_SET(m_pBuffer4x[16 + k + j], nPort);
-			} else {
-				BIT_CLEAR(m_pBuffer4x[16 + k + j], nPort);
-			}
-			if (mask & nRed) {
-				BIT_SET(m_pBuffer4x[8 + k + j], nPort);
-			} else {
-				BIT_CLEAR(m_pBuffer4x[8 + k + j], nPort);
-			}
-			break;
-		case RGB_MAPPING_BRG:
-			if (mask & nBlue) {
-				BIT_SET(m_pBuffer4x[k + j], nPort);
-			} else {
-				BIT_CLEAR(m_pBuffer4x[k + j], nPort);
-			}
-			if (mask & nRed) {
-				BIT_SET(m_pBuffer4x[8 + k + j], nPort);
-			} else {
-				BIT_CLEAR(m_pBuffer4x[8 + k + j], nPort);
-			}
-			if (mask & nGreen) {
-				BIT_SET(m_pBuffer4x[16 + k + j], nPort);
-			} else {
-				BIT_CLEAR(m_pBuffer4x[16 + k + j], nPort);
-			}
-			break;
-		case RGB_MAPPING_BGR:
-			if (mask & nBlue) {
-				BIT_SET(m_pBuffer4x[k + j], nPort);
-			} else {
-				BIT_CLEAR(m_pBuffer4x[k + j], nPort);
-			}
-			if (mask & nGreen) {
-				BIT_SET(m_pBuffer4x[16 + k + j], nPort);
-			} else {
-				BIT_CLEAR(m_pBuffer4x[16 + k + j], nPort);
-			}
-			if (mask & nRed) {
-				BIT_SET(m_pBuffer4x[8 + k + j], nPort);
-			} else {
-				BIT_CLEAR(m_pBuffer4x[8 + k + j], nPort);
-			}
-			break;
-		default:
-			if (mask & nGreen) {
-				BIT_SET(m_pBuffer4x[k + j], nPort);
-			} else {
-				BIT_CLEAR(m_pBuffer4x[k + j], nPort);
-			}
-			if (mask & nRed) {
-				BIT_SET(m_pBuffer4x[8 + k + j], nPort);
-			} else {
-				BIT_CLEAR(m_pBuffer4x[8 + k + j], nPort);
-			}
-			if (mask & nBlue) {
-				BIT_SET(m_pBuffer4x[16 + k + j], nPort);
-			} else {
-				BIT_CLEAR(m_pBuffer4x[16 + k + j], nPort);
-			}
-			break;
+	SetColour(&pBuffer[rgbmapping::Order<tRGBMapping>::R * 8], nPort, nRed);
+	SetColour(&pBuffer[rgbmapping::Order<tRGBMapping>::G * 8], nPort, nGreen);
+	SetColour(&pBuffer[rgbmapping::Order<tRGBMapping>::B * 8], nPort, nBlue);
+}
+
+template<TRGBMapping tRGBMapping>
+void WS28xxMulti::SetLEDs4x(uint8_t nPort, uint32_t nFirstLed, const uint8_t *pData, uint32_t nCount, uint32_t nGroupCount) {
+	assert(nPort < 4);
+
+	uint32_t *pBuffer = &m_pBuffer4x[nFirstLed * SINGLE_RGB];
+
+	for (uint32_t i = 0; i < nCount; i++) {
+		SetColour(&pBuffer[rgbmapping::Order<tRGBMapping>::R * 8], nPort, pData[0]);
+		SetColour(&pBuffer[rgbmapping::Order<tRGBMapping>::G * 8], nPort, pData[1]);
+		SetColour(&pBuffer[rgbmapping::Order<tRGBMapping>::B * 8], nPort, pData[2]);
+		if (nGroupCount != 1) {
+			Replicate(pBuffer, nPort, SINGLE_RGB, nGroupCount);
 		}
+		pBuffer += SINGLE_RGB * nGroupCount;
+		pData += 3;
+	}
+}
 
-		j++;
+void WS28xxMulti::SetLEDsRGBW4x(uint8_t nPort, uint32_t nFirstLed, const uint8_t *pData, uint32_t nCount, uint32_t nGroupCount) {
+	assert(nPort < 4);
+
+	uint32_t *pBuffer = &m_pBuffer4x[nFirstLed * SINGLE_RGBW];
+
+	for (uint32_t i = 0; i < nCount; i++) {
+		// GRBW
+		SetColour(&pBuffer[0], nPort, pData[1]);
+		SetColour(&pBuffer[8], nPort, pData[0]);
+		SetColour(&pBuffer[16], nPort, pData[2]);
+		SetColour(&pBuffer[24], nPort, pData[3]);
+		if (nGroupCount != 1) {
+			Replicate(pBuffer, nPort, SINGLE_RGBW, nGroupCount);
+		}
+		pBuffer += SINGLE_RGBW * nGroupCount;
+		pData += 4;
+	}
+}
+
+void WS28xxMulti::SetupEncoder4x() {
+	switch (m_tRGBMapping) {
+	case RGB_MAPPING_RGB:
+		m_pSetLED = &WS28xxMulti::SetLED4x<RGB_MAPPING_RGB>;
+		m_pSetLEDs = &WS28xxMulti::SetLEDs4x<RGB_MAPPING_RGB>;
+		break;
+	case RGB_MAPPING_RBG:
+		m_pSetLED = &WS28xxMulti::SetLED4x<RGB_MAPPING_RBG>;
+		m_pSetLEDs = &WS28xxMulti::SetLEDs4x<RGB_MAPPING_RBG>;
+		break;
+	case RGB_MAPPING_GBR:
+		m_pSetLED = &WS28xxMulti::SetLED4x<RGB_MAPPING_GBR>;
+		m_pSetLEDs = &WS28xxMulti::SetLEDs4x<RGB_MAPPING_GBR>;
+		break;
+	case RGB_MAPPING_BRG:
+		m_pSetLED = &WS28xxMulti::SetLED4x<RGB_MAPPING_BRG>;
+		m_pSetLEDs = &WS28xxMulti::SetLEDs4x<RGB_MAPPING_BRG>;
+		break;
+	case RGB_MAPPING_BGR:
+		m_pSetLED = &WS28xxMulti::SetLED4x<RGB_MAPPING_BGR>;
+		m_pSetLEDs = &WS28xxMulti::SetLEDs4x<RGB_MAPPING_BGR>;
+		break;
+	default:  // GRB
+		m_pSetLED = &WS28xxMulti::SetLED4x<RGB_MAPPING_GRB>;
+		m_pSetLEDs = &WS28xxMulti::SetLEDs4x<RGB_MAPPING_GRB>;
+		break;
+	}
+
+	if (m_tWS28xxType == SK6812W) {
+		m_pSetLEDs = &WS28xxMulti::SetLEDsRGBW4x;
 	}
 }
 
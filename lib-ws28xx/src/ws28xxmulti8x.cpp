@@ -68,141 +68,57 @@ void WS28xxMulti::SetupSPI() {
 	DEBUG_EXIT
 }
 
-#define BIT_SET(a,b) 	((a) |= (1<<(b)))
-#define BIT_CLEAR(a,b) 	((a) &= ~(1<<(b)))
+/*
+ * The 8 bytes hold the same slot for port 0..7 (byte n is port n).
+ * Returned is per colour bit, MSB first, a byte with bit n set for port n.
+ */
+static uint64_t Transpose8x8(uint64_t x) {
+	uint64_t t;
+
+	t = (x ^ (x >> 7)) & 0x00AA00AA00AA00AAULL;
+	x = x ^ t ^ (t << 7);
+	t = (x ^ (x >> 14)) & 0x0000CCCC0000CCCCULL;
+	x = x ^ t ^ (t << 14);
+	t = (x ^ (x >> 28)) & 0x00000000F0F0F0F0ULL;
+	x = x ^ t ^ (t << 28);
+
+	return __builtin_bswap64(x);
+}
+
+void WS28xxMulti::Encode8x() {
+	if (m_nPixelsFirst8x > m_nPixelsLast8x) {
+		return;
+	}
+
+	const uint8_t *pPixels = &m_pPixels8x[m_nPixelsFirst8x * 8];
+	uint8_t *pBuffer = &m_pBuffer8x[m_nPixelsFirst8x * 8];
+
+	for (uint32_t i = m_nPixelsFirst8x; i <= m_nPixelsLast8x; i++) {
+		uint64_t nSlot;
+		memcpy(&nSlot, pPixels, 8);
+		nSlot = Transpose8x8(nSlot);
+		memcpy(pBuffer, &nSlot, 8);
+
+		pPixels += 8;
+		pBuffer += 8;
+	}
+
+	m_nPixelsFirst8x = UINT32_MAX;
+	m_nPixelsLast8x = 0;
+}
 
+template<TRGBMapping tRGBMapping>
 void WS28xxMulti::SetLED8x(uint8_t nPort, uint16_t nLedIndex, uint8_t nRed, uint8_t nGreen, uint8_t nBlue) {
 	assert(nPort < 8);
 	assert(nLedIndex < m_nLedCount);
 
-	uint32_t j = 0;
-	uint32_t k = static_cast<uint32_t>(nLedIndex * SINGLE_RGB);
-
-	for (uint8_t mask = 0x80; mask != 0; mask >>= 1) {
-		switch (m_tRGBMapping) {
-		case RGB_MAPPING_RGB:
-			if (mask & nRed) {
-				BIT_SET(m_pBuffer8x[k + j], nPort);
-			} else {
-				BIT_CLEAR(m_pBuffer8x[k + j], nPort);
-			}
-			if (mask & nGreen) {
-				BIT_SET(m_pBuffer8x[8 + k + j], nPort);
-			} else {
-				BIT_CLEAR(m_pBuffer8x[8 + k + j], nPort);
-			}
-			if (mask & nBlue) {
-				BIT_SET(m_pBuffer8x[16 + k + j], nPort);
-			} else {
-				BIT_CLEAR(m_pBuffer8x[16 + k + j], nPort);
-			}
-			break;
-		case RGB_MAPPING_RBG:
-			if (mask & nRed) {
-				BIT_SET(m_pBuffer8x[k + j], nPort);
-			} else {
-				BIT_CLEAR(m_pBuffer8x[k + j], nPort);
-			}
-			if (mask & nBlue) {
-				BIT_SET(m_pBuffer8x[16 + k + j], nPort);
-			} else {
-				BIT_CLEAR(m_pBuffer8x[16 + k + j], nPort);
-			}
-			if (mask & nGreen) {
-				BIT_SET(m_pBuffer8x[8 + k + j], nPort);
-			} else {
-				BIT_CLEAR(m_pBuffer8x[8 + k + j], nPort);
-			}
-			break;
-		case RGB_MAPPING_GRB:
-			if (mask & nGreen) {
-				BIT_SET(m_pBuffer8x[k + j], nPort);
-			} else {
-				BIT_CLEAR(m_pBuffer8x[k + j], nPort);
-			}
-			if (mask & nRed) {
-				BIT_SET(m_pBuffer8x[8 + k + j], nPort);
-			} else {
-				BIT_CLEAR(m_pBuffer8x[8 + k + j], nPort);
-			}
-			if (mask & nBlue) {
-				BIT_SET(m_pBuffer8x[16 + k + j], nPort);
-			} else {
-				BIT_CLEAR(m_pBuffer8x[16 + k + j], nPort);
-			}
-			break;
-		case RGB_MAPPING_GBR:
-			if (mask & nGreen) {
-				BIT_SET(m_pBuffer8x[k + j], nPort);
-			} else {
-				BIT_CLEAR(m_pBuffer8x[k + j], nPort);
-			}
-			if (mask & nBlue) {
-				BIT_SET(m_pBuffer8x[16 + k + j], nPort);
-			} else {
-				BIT_CLEAR(m_pBuffer8x[16 + k + j], nPort);
-			}
-			if (mask & nRed) {
-				BIT_SET(m_pBuffer8x[8 + k + j], nPort);
-			} else {
-				BIT_CLEAR(m_pBuffer8x[8 + k + j], nPort);
-			}
-			break;
-		case RGB_MAPPING_BRG:
-			if (mask & nBlue) {
-				BIT_SET(m_pBuffer8x[k + j], nPort);
-			} else {
-				BIT_CLEAR(m_pBuffer8x[k + j], nPort);
-			}
-			if (mask & nRed) {
-				BIT_SET(m_pBuffer8x[8 + k + j], nPort);
-			} else {
-				BIT_CLEAR(m_pBuffer8x[8 + k + j], nPort);
-			}
-			if (mask & nGreen) {
-				BIT_SET(m_pBuffer8x[16 + k + j], nPort);
-			} else {
-				BIT_CLEAR(m_pBuffer8x[16 + k + j], nPort);
-			}
-			break;
-		case RGB_MAPPING_BGR:
-			if (mask & nBlue) {
-				BIT_SET(m_pBuffer8x[k + j], nPort);
-			} else {
-				BIT_CLEAR(m_pBuffer8x[k + j], nPort);
-			}
-			if (mask & nGreen) {
-				BIT_SET(m_pBuffer8x[16 + k + j], nPort);
-			} else {
-				BIT_CLEAR(m_pBuffer8x[16 + k + j], nPort);
-			}
-			if (mask & nRed) {
-				BIT_SET(m_pBuffer8x[8 + k + j], nPort);
-			} else {
-				BIT_CLEAR(m_pBuffer8x[8 + k + j], nPort);
-			}
-			break;
-		default:
-			if (mask & nGreen) {
-				BIT_SET(m_pBuffer8x[k + j], nPort);
-			} else {
-				BIT_CLEAR(m_pBuffer8x[k + j], nPort);
-			}
-			if (mask & nRed) {
-				BIT_SET(m_pBuffer8x[8 + k + j], nPort);
-			} else {
-				BIT_CLEAR(m_pBuffer8x[8 + k + j], nPort);
-			}
-			if (mask & nBlue) {
-				BIT_SET(m_pBuffer8x[16 + k + j], nPort);
-			} else {
-				BIT_CLEAR(m_pBuffer8x[16 + k + j], nPort);
-			}
-			break;
-		}
+	uint8_t *pPixels = &m_pPixels8x[static_cast<uint32_t>(nLedIndex * SINGLE_RGB) + nPort];
 
-		j++;
-	}
+	pPixels[rgbmapping::Order<tRGBMapping>::R * 8] = nRed;
+	pPixels[rgbmapping::Order<tRGBMapping>::G * 8] = nGreen;
+	pPixels[rgbmapping::Order<tRGBMapping>::B * 8] = nBlue;
+
+	SetPixelsDirty8x(nLedIndex * 3U, nLedIndex * 3U + 2);
 }
 
 void WS28xxMulti::SetLED8x(uint8_t nPort, uint16_t nLedIndex, uint8_t nRed, uint8_t nGreen, uint8_t nBlue, uint8_t nWhite) {
@@ -210,35 +126,102 @@ void WS28xxMulti::SetLED8x(uint8_t nPort, uint16_t nLedIndex, uint8_t nRed, uint
 	assert(nLedIndex < m_nLedCount);
 	assert(m_tWS28xxType == SK6812W);
 
-	uint32_t j = 0;
-	uint32_t k = static_cast<uint32_t>(nLedIndex * SINGLE_RGBW);
+	uint8_t *pPixels = &m_pPixels8x[static_cast<uint32_t>(nLedIndex * SINGLE_RGBW) + nPort];
 
-	for (uint8_t mask = 0x80; mask != 0; mask >>= 1) {
-		// GRBW
-		if (mask & nGreen) {
-			BIT_SET(m_pBuffer8x[k + j], nPort);
-		} else {
-			BIT_CLEAR(m_pBuffer8x[k + j], nPort);
-		}
+	// GRBW
+	pPixels[0] = nGreen;
+	pPixels[8] = nRed;
+	pPixels[16] = nBlue;
+	pPixels[24] = nWhite;
 
-		if (mask & nRed) {
-			BIT_SET(m_pBuffer8x[8 + k + j], nPort);
-		} else {
-			BIT_CLEAR(m_pBuffer8x[8 + k + j], nPort);
-		}
+	SetPixelsDirty8x(nLedIndex * 4U, nLedIndex * 4U + 3);
+}
 
-		if (mask & nBlue) {
-			BIT_SET(m_pBuffer8x[16 + k + j], nPort);
-		} else {
-			BIT_CLEAR(m_pBuffer8x[16 + k + j], nPort);
+template<TRGBMapping tRGBMapping>
+void WS28xxMulti::SetLEDs8x(uint8_t nPort, uint32_t nFirstLed, const uint8_t *pData, uint32_t nCount, uint32_t nGroupCount) {
+	assert(nPort < 8);
+
+	if (nCount == 0) {
+		return;
+	}
+
+	uint8_t *pPixels = &m_pPixels8x[nFirstLed * SINGLE_RGB + nPort];
+
+	for (uint32_t i = 0; i < nCount; i++) {
+		for (uint32_t k = 0; k < nGroupCount; k++) {
+			pPixels[rgbmapping::Order<tRGBMapping>::R * 8] = pData[0];
+			pPixels[rgbmapping::Order<tRGBMapping>::G * 8] = pData[1];
+			pPixels[rgbmapping::Order<tRGBMapping>::B * 8] = pData[2];
+			pPixels += SINGLE_RGB;
 		}
+		pData += 3;
+	}
+
+	SetPixelsDirty8x(nFirstLed * 3, (nFirstLed + (nCount * nGroupCount)) * 3 - 1);
+}
+
+void WS28xxMulti::SetLEDsRGBW8x(uint8_t nPort, uint32_t nFirstLed, const uint8_t *pData, uint32_t nCount, uint32_t nGroupCount) {
+	assert(nPort < 8);
+
+	if (nCount == 0) {
+		return;
+	}
 
-		if (mask & nWhite) {
-			BIT_SET(m_pBuffer8x[24 + k + j], nPort);
-		} else {
-			BIT_CLEAR(m_pBuffer8x[24 + k + j], nPort);
+	uint8_t *pPixels = &m_pPixels8x[nFirstLed * SINGLE_RGBW + nPort];
+
+	for (uint32_t i = 0; i < nCount; i++) {
+		for (uint32_t k = 0; k < nGroupCount; k++) {
+			// GRBW
+			pPixels[0] = pData[1];
+			pPixels[8] = pData[0];
+			pPixels[16] = pData[2];
+			pPixels[24] = pData[3];
+			pPixels += SINGLE_RGBW;
 		}
+		pData += 4;
+	}
+
+	SetPixelsDirty8x(nFirstLed * 4, (nFirstLed + (nCount * nGroupCount)) * 4 - 1);
+}
+
+void WS28xxMulti::SetupEncoder8x() {
+	assert(m_pPixels8x == nullptr);
+
+	const uint32_t nSize = m_nLedCount * static_cast<uint32_t>(m_tWS28xxType == SK6812W ? SINGLE_RGBW : SINGLE_RGB);
+
+	m_pPixels8x = new uint8_t[nSize];
+	assert(m_pPixels8x != nullptr);
+
+	memset(m_pPixels8x, 0, nSize);
+
+	switch (m_tRGBMapping) {
+	case RGB_MAPPING_RGB:
+		m_pSetLED = &WS28xxMulti::SetLED8x<RGB_MAPPING_RGB>;
+		m_pSetLEDs = &WS28xxMulti::SetLEDs8x<RGB_MAPPING_RGB>;
+		break;
+	case RGB_MAPPING_RBG:
+		m_pSetLED = &WS28xxMulti::SetLED8x<RGB_MAPPING_RBG>;
+		m_pSetLEDs = &WS28xxMulti::SetLEDs8x<RGB_MAPPING_RBG>;
+		break;
+	case RGB_MAPPING_GBR:
+		m_pSetLED = &WS28xxMulti::SetLED8x<RGB_MAPPING_GBR>;
+		m_pSetLEDs = &WS28xxMulti::SetLEDs8x<RGB_MAPPING_GBR>;
+		break;
+	case RGB_MAPPING_BRG:
+		m_pSetLED = &WS28xxMulti::SetLED8x<RGB_MAPPING_BRG>;
+		m_pSetLEDs = &WS28xxMulti::SetLEDs8x<RGB_MAPPING_BRG>;
+		break;
+	case RGB_MAPPING_BGR:
+		m_pSetLED = &WS28xxMulti::SetLED8x<RGB_MAPPING_BGR>;
+		m_pSetLEDs = &WS28xxMulti::SetLEDs8x<RGB_MAPPING_BGR>;
+		break;
+	default:  // GRB
+		m_pSetLED = &WS28xxMulti::SetLED8x<RGB_MAPPING_GRB>;
+		m_pSetLEDs = &WS28xxMulti::SetLEDs8x<RGB_MAPPING_GRB>;
+		break;
+	}
 
-		j++;
+	if (m_tWS28xxType == SK6812W) {
+		m_pSetLEDs = &WS28xxMulti::SetLEDsRGBW8x;
 	}
 }
@@ -24,97 +24,187 @@
  */
 
 #include <stdint.h>
+#include <string.h>
 #include <cassert>
 
 #include "ws28xx.h"
 #include "rgbmapping.h"
 
+namespace ws28xx {
+/**
+ * The encoded LED at pBuffer is replicated to the next nCopies - 1 LEDs,
+ * doubling the copied block each time.
+ */
+static void fill(uint8_t *pBuffer, uint32_t nLedSize, uint32_t nCopies) {
+	const uint32_t nTotal = nLedSize * nCopies;
+	uint32_t nDone = nLedSize;
+
+	while (nDone < nTotal) {
+		const uint32_t nSize = (nTotal - nDone) < nDone ? (nTotal - nDone) : nDone;
+		memcpy(&pBuffer[nDone], pBuffer, nSize);
+		nDone += nSize;
+	}
+}
+}  // namespace ws28xx
 
-void WS28xx::SetLED(uint32_t nLEDIndex, uint8_t nRed, uint8_t nGreen, uint8_t nBlue) {
-	assert(m_pBuffer != nullptr);
-	assert(nLEDIndex < m_nLedCount);
+template<TRGBMapping tRGBMapping>
+void WS28xx::SetLEDRTZ(uint32_t nLEDIndex, uint8_t nRed, uint8_t nGreen, uint8_t nBlue) {
+	const uint32_t nOffset = nLEDIndex * SINGLE_RGB;
 
-	if (__builtin_expect((m_bIsRTZProtocol), 1)) {
-		uint32_t nOffset = nLEDIndex * 3;
-		nOffset *= 8;
+	SetColorWS28xx(nOffset + rgbmapping::Order<tRGBMapping>::R * 8, nRed);
+	SetColorWS28xx(nOffset + rgbmapping::Order<tRGBMapping>::G * 8, nGreen);
+	SetColorWS28xx(nOffset + rgbmapping::Order<tRGBMapping>::B * 8, nBlue);
+}
+
+void WS28xx::SetLEDAPA102(uint32_t nLEDIndex, uint8_t nRed, uint8_t nGreen, uint8_t nBlue) {
+	const uint32_t nOffset = 4 + (nLEDIndex * 4);
+	assert(nOffset + 3 < m_nBufSize);
+
+	m_pBuffer[nOffset] = m_nGlobalBrightness;
+	m_pBuffer[nOffset + 1] = nRed;
+	m_pBuffer[nOffset + 2] = nGreen;
+	m_pBuffer[nOffset + 3] = nBlue;
+}
+
+void WS28xx::SetLEDWS2801(uint32_t nLEDIndex, uint8_t nRed, uint8_t nGreen, uint8_t nBlue) {
+	const uint32_t nOffset = nLEDIndex * 3;
+	assert(nOffset + 2 < m_nBufSize);
+
+	m_pBuffer[nOffset] = nRed;
+	m_pBuffer[nOffset + 1] = nGreen;
+	m_pBuffer[nOffset + 2] = nBlue;
+}
+
+void WS28xx::SetLEDP9813(uint32_t nLEDIndex, uint8_t nRed, uint8_t nGreen, uint8_t nBlue) {
+	const uint32_t nOffset = 4 + (nLEDIndex * 4);
+	assert(nOffset + 3 < m_nBufSize);
+
+	const uint8_t nFlag = 0xC0 | ((~nBlue & 0xC0) >> 2) | ((~nGreen & 0xC0) >> 4) | ((~nRed & 0xC0) >> 6);
+
+	m_pBuffer[nOffset] = nFlag;
+	m_pBuffer[nOffset + 1] = nBlue;
+	m_pBuffer[nOffset + 2] = nGreen;
+	m_pBuffer[nOffset + 3] = nRed;
+}
+
+template<TRGBMapping tRGBMapping>
+void WS28xx::SetLEDsRTZ(uint32_t nFirstLed, const uint8_t *pData, uint32_t nCount, uint32_t nGroupCount) {
+	uint8_t *pBuffer = &m_pBuffer[nFirstLed * SINGLE_RGB];
+
+	if (nGroupCount == 1) {
+		for (uint32_t i = 0; i < nCount; i++) {
+			__builtin_prefetch(&pData[3]);
+			memcpy(&pBuffer[rgbmapping::Order<tRGBMapping>::R * 8], &m_aRTZTable[pData[0]], 8);
+			memcpy(&pBuffer[rgbmapping::Order<tRGBMapping>::G * 8], &m_aRTZTable[pData[1]], 8);
+			memcpy(&pBuffer[rgbmapping::Order<tRGBMapping>::B * 8], &m_aRTZTable[pData[2]], 8);
+			pBuffer += SINGLE_RGB;
+			pData += 3;
+		}
+		return;
+	}
+
+	// A group is encoded once, then replicated
+	for (uint32_t i = 0; i < nCount; i++) {
+		memcpy(&pBuffer[rgbmapping::Order<tRGBMapping>::R * 8], &m_aRTZTable[pData[0]], 8);
+		memcpy(&pBuffer[rgbmapping::Order<tRGBMapping>::G * 8], &m_aRTZTable[pData[1]], 8);
+		memcpy(&pBuffer[rgbmapping::Order<tRGBMapping>::B * 8], &m_aRTZTable[pData[2]], 8);
+		ws28xx::fill(pBuffer, SINGLE_RGB, nGroupCount);
+		pBuffer += SINGLE_RGB * nGroupCount;
+		pData += 3;
+	}
+}
+
+void WS28xx::SetLEDsRTZW(uint32_t nFirstLed, const uint8_t *pData, uint32_t nCount, uint32_t nGroupCount) {
+	uint8_t *pBuffer = &m_pBuffer[nFirstLed * SINGLE_RGBW];
+
+	for (uint32_t i = 0; i < nCount; i++) {
+		__builtin_prefetch(&pData[4]);
+		// GRBW
+		memcpy(&pBuffer[0], &m_aRTZTable[pData[1]], 8);
+		memcpy(&pBuffer[8], &m_aRTZTable[pData[0]], 8);
+		memcpy(&pBuffer[16], &m_aRTZTable[pData[2]], 8);
+		memcpy(&pBuffer[24], &m_aRTZTable[pData[3]], 8);
+		if (nGroupCount != 1) {
+			ws28xx::fill(pBuffer, SINGLE_RGBW, nGroupCount);
+		}
+		pBuffer += SINGLE_RGBW * nGroupCount;
+		pData += 4;
+	}
+}
+
+void WS28xx::SetLEDsSPI(uint32_t nFirstLed, const uint8_t *pData, uint32_t nCount, uint32_t nGroupCount) {
+	if (nGroupCount == 1) {
+		for (uint32_t i = 0; i < nCount; i++) {
+			(this->*m_pSetLED)(nFirstLed++, pData[0], pData[1], pData[2]);
+			pData += 3;
+		}
+		return;
+	}
+
+	// WS2801 is 3 bytes a LED, APA102 and P9813 are 4 bytes a LED after a 4 bytes start frame
+	const uint32_t nLedSize = (m_tLEDType == WS2801) ? 3 : 4;
+	const uint32_t nStart = (m_tLEDType == WS2801) ? 0 : 4;
 
+	for (uint32_t i = 0; i < nCount; i++) {
+		(this->*m_pSetLED)(nFirstLed, pData[0], pData[1], pData[2]);
+		ws28xx::fill(&m_pBuffer[nStart + (nFirstLed * nLedSize)], nLedSize, nGroupCount);
+		nFirstLed += nGroupCount;
+		pData += 3;
+	}
+}
+
+/*
+ * Only the 6 RTZ mappings are instantiated, the SPI clock based types have a fixed order.
+ */
+void WS28xx::SetupEncoder() {
+	if (m_bIsRTZProtocol) {
 		switch (m_tRGBMapping) {
-		case RGB_MAPPING_RGB:
-			SetColorWS28xx(nOffset, nRed);
-			SetColorWS28xx(nOffset + 8, nGreen);
-			SetColorWS28xx(nOffset + 16, nBlue);
-			break;
 		case RGB_MAPPING_RBG:
-			SetColorWS28xx(nOffset, nRed);
-			SetColorWS28xx(nOffset + 8, nBlue);
-			SetColorWS28xx(nOffset + 16, nGreen);
+			m_pSetLED = &WS28xx::SetLEDRTZ<RGB_MAPPING_RBG>;
+			m_pSetLEDs = &WS28xx::SetLEDsRTZ<RGB_MAPPING_RBG>;
 			break;
 		case RGB_MAPPING_GRB:
-			SetColorWS28xx(nOffset, nGreen);
-			SetColorWS28xx(nOffset + 8, nRed);
-			SetColorWS28xx(nOffset + 16, nBlue);
+			m_pSetLED = &WS28xx::SetLEDRTZ<RGB_MAPPING_GRB>;
+			m_pSetLEDs = &WS28xx::SetLEDsRTZ<RGB_MAPPING_GRB>;
 			break;
 		case RGB_MAPPING_GBR:
-			SetColorWS28xx(nOffset, nGreen);
-			SetColorWS28xx(nOffset + 8, nBlue);
-			SetColorWS28xx(nOffset + 16, nRed);
+			m_pSetLED = &WS28xx::SetLEDRTZ<RGB_MAPPING_GBR>;
+			m_pSetLEDs = &WS28xx::SetLEDsRTZ<RGB_MAPPING_GBR>;
 			break;
 		case RGB_MAPPING_BRG:
-			SetColorWS28xx(nOffset, nBlue);
-			SetColorWS28xx(nOffset + 8, nRed);
-			SetColorWS28xx(nOffset + 16, nGreen);
+			m_pSetLED = &WS28xx::SetLEDRTZ<RGB_MAPPING_BRG>;
+			m_pSetLEDs = &WS28xx::SetLEDsRTZ<RGB_MAPPING_BRG>;
 			break;
 		case RGB_MAPPING_BGR:
-			SetColorWS28xx(nOffset, nBlue);
-			SetColorWS28xx(nOffset + 8, nGreen);
-			SetColorWS28xx(nOffset + 16, nRed);
+			m_pSetLED = &WS28xx::SetLEDRTZ<RGB_MAPPING_BGR>;
+			m_pSetLEDs = &WS28xx::SetLEDsRTZ<RGB_MAPPING_BGR>;
 			break;
 		default:  // RGB
-			SetColorWS28xx(nOffset, nRed);
-			SetColorWS28xx(nOffset + 8, nGreen);
-			SetColorWS28xx(nOffset + 16, nBlue);
+			m_pSetLED = &WS28xx::SetLEDRTZ<RGB_MAPPING_RGB>;
+			m_pSetLEDs = &WS28xx::SetLEDsRTZ<RGB_MAPPING_RGB>;
 			break;
 		}
 
-		return;
-	}
-
-	if (m_tLEDType == APA102) {
-		uint32_t nOffset = 4 + (nLEDIndex * 4);
-		assert(nOffset + 3 < m_nBufSize);
-
-		m_pBuffer[nOffset] = m_nGlobalBrightness;
-		m_pBuffer[nOffset + 1] = nRed;
-		m_pBuffer[nOffset + 2] = nGreen;
-		m_pBuffer[nOffset + 3] = nBlue;
+		if (m_tLEDType == SK6812W) {
+			m_pSetLEDs = &WS28xx::SetLEDsRTZW;
+		}
 
 		return;
 	}
 
-	if (m_tLEDType == WS2801) {
-		uint32_t nOffset = nLEDIndex * 3;
-		assert(nOffset + 2 < m_nBufSize);
-
-		m_pBuffer[nOffset] = nRed;
-		m_pBuffer[nOffset + 1] = nGreen;
-		m_pBuffer[nOffset + 2] = nBlue;
+	m_pSetLEDs = &WS28xx::SetLEDsSPI;
 
+	if (m_tLEDType == APA102) {
+		m_pSetLED = &WS28xx::SetLEDAPA102;
 		return;
 	}
 
 	if (m_tLEDType == P9813) {
-		uint32_t nOffset = 4 + (nLEDIndex * 4);
-		assert(nOffset + 3 < m_nBufSize);
-
-		const uint8_t nFlag = 0xC0 | ((~nBlue & 0xC0) >> 2) | ((~nGreen & 0xC0) >> 4) | ((~nRed & 0xC0) >> 6);
-
-		m_pBuffer[nOffset] = nFlag;
-		m_pBuffer[nOffset + 1] = nBlue;
-		m_pBuffer[nOffset + 2] = nGreen;
-		m_pBuffer[nOffset + 3] = nRed;
-
+		m_pSetLED = &WS28xx::SetLEDP9813;
 		return;
 	}
+
+	m_pSetLED = &WS28xx::SetLEDWS2801;
 }
 
 void WS28xx::SetLED(uint32_t nLEDIndex, uint8_t nRed, uint8_t nGreen, uint8_t nBlue, uint8_t nWhite) {
@@ -134,18 +224,23 @@ void WS28xx::SetLED(uint32_t nLEDIndex, uint8_t nRed, uint8_t nGreen, uint8_t nB
 	}
 }
 
+void WS28xx::SetupRTZTable() {
+	for (uint32_t nValue = 0; nValue < 256; nValue++) {
+		uint8_t aCodes[8];
+
+		for (uint32_t i = 0; i < 8; i++) {
+			aCodes[i] = (nValue & (0x80U >> i)) ? m_nHighCode : m_nLowCode;
+		}
+
+		memcpy(&m_aRTZTable[nValue], aCodes, 8);
+	}
+}
+
 void WS28xx::SetColorWS28xx(uint32_t nOffset, uint8_t nValue) {
 	assert(m_tLEDType != WS2801);
 	assert(nOffset + 7 < m_nBufSize);
 
-	for (uint8_t mask = 0x80; mask != 0; mask >>= 1) {
-		if (nValue & mask) {
-			m_pBuffer[nOffset] = m_nHighCode;
-		} else {
-			m_pBuffer[nOffset] = m_nLowCode;
-		}
-		nOffset++;
-	}
+	memcpy(&m_pBuffer[nOffset], &m_aRTZTable[nValue], 8);
 }
 
 void WS28xx::SetGlobalBrightness(uint8_t nGlobalBrightness) {
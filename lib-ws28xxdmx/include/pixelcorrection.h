@@ -0,0 +1,125 @@
+/**
+ * @file pixelcorrection.h
+ *
+ */
+/* Copyright (C) 2020 by Arjan van Vught mailto:info@orangepi-dmx.nl
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#ifndef PIXELCORRECTION_H_
+#define PIXELCORRECTION_H_
+
+#include <stdint.h>
+
+/**
+ * Gamma and white balance correction between the DMX data and the LED encoders.
+ *
+ * The tables are generated once, a channel costs one table load per frame.
+ * With temporal dithering the tables are 8.8 fixed point, the fraction is spread over
+ * the frames that are re-sent from the retained input when the output is faster than the input.
+ */
+class PixelCorrection {
+public:
+	static constexpr uint32_t MAX_CHANNELS = 4;	///< DMX order R, G, B, W
+	static constexpr float GAMMA_DEFAULT = 1.0f;
+
+	PixelCorrection();
+	~PixelCorrection();
+
+	void SetGamma(float fGamma) {
+		m_fGamma = fGamma;
+	}
+
+	void SetWhiteBalance(uint8_t nRed, uint8_t nGreen, uint8_t nBlue, uint8_t nWhite);
+
+	void SetDither(bool bDither) {
+		m_bDither = bDither;
+	}
+
+	void Generate();
+
+	bool IsEnabled() const {
+		return m_bEnabled;
+	}
+
+	bool IsDither() const {
+		return m_bEnabled && m_bDither;
+	}
+
+	void NextFrame() {
+		m_nFrame++;
+	}
+
+	/**
+	 * pIn and pOut are nCount pixels of nChannelsPerLed (3 or 4) channels, nFirstLed is the spatial dither offset
+	 */
+	void Apply(const uint8_t *pIn, uint8_t *pOut, uint32_t nFirstLed, uint32_t nCount, uint32_t nChannelsPerLed) const {
+		if (m_bDither) {
+			ApplyDither(pIn, pOut, nFirstLed, nCount, nChannelsPerLed);
+			return;
+		}
+
+		if (nChannelsPerLed == 4) {
+			for (uint32_t i = 0; i < nCount; i++) {
+				pOut[0] = m_aLut[0][pIn[0]];
+				pOut[1] = m_aLut[1][pIn[1]];
+				pOut[2] = m_aLut[2][pIn[2]];
+				pOut[3] = m_aLut[3][pIn[3]];
+				pIn += 4;
+				pOut += 4;
+			}
+			return;
+		}
+
+		for (uint32_t i = 0; i < nCount; i++) {
+			pOut[0] = m_aLut[0][pIn[0]];
+			pOut[1] = m_aLut[1][pIn[1]];
+			pOut[2] = m_aLut[2][pIn[2]];
+			pIn += 3;
+			pOut += 3;
+		}
+	}
+
+	/**
+	 * The input of nPorts ports is kept for re-sending dithered frames
+	 */
+	void SetupRetain(uint32_t nPorts);
+	void Retain(uint32_t nPort, const uint8_t *pData, uint32_t nLength);
+	const uint8_t *GetRetained(uint32_t nPort, uint32_t &nLength) const;
+
+	void Print();
+
+private:
+	void ApplyDither(const uint8_t *pIn, uint8_t *pOut, uint32_t nFirstLed, uint32_t nCount, uint32_t nChannelsPerLed) const;
+
+private:
+	float m_fGamma{GAMMA_DEFAULT};
+	uint8_t m_aWhiteBalance[MAX_CHANNELS];
+	bool m_bDither{false};
+	bool m_bEnabled{false};
+	uint32_t m_nFrame{0};
+	uint8_t m_aLut[MAX_CHANNELS][256];
+	uint16_t m_aLut16[MAX_CHANNELS][256];	///< 8.8 fixed point, at most 0xFF00
+	uint8_t *m_pRetained{nullptr};
+	uint16_t *m_pRetainedLength{nullptr};
+	uint32_t m_nRetainedPorts{0};
+};
+
+#endif /* PIXELCORRECTION_H_ */
@@ -0,0 +1,85 @@
+/**
+ * @file pixeleffects.h
+ *
+ */
+/* Copyright (C) 2020 by Arjan van Vught mailto:info@orangepi-dmx.nl
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#ifndef PIXELEFFECTS_H_
+#define PIXELEFFECTS_H_
+
+#include <stdint.h>
+
+enum TPixelEffect {
+	PIXEL_EFFECT_NONE,		///< Black
+	PIXEL_EFFECT_SOLID,
+	PIXEL_EFFECT_CHASE,
+	PIXEL_EFFECT_RAINBOW,
+	PIXEL_EFFECT_NOISE,
+	PIXEL_EFFECT_BREATHE,
+	PIXEL_EFFECT_UNDEFINED
+};
+
+/**
+ * Fixed point effects, rendered as DMX ordered pixels (R, G, B [, W]) for the bulk encoders.
+ * Used as the failsafe scene on network data loss.
+ */
+class PixelEffects {
+public:
+	static constexpr uint32_t MAX_OUTPUTS = 8;
+	static constexpr uint32_t CYCLE_MILLIS_DEFAULT = 4000;
+
+	PixelEffects();
+
+	void SetEffect(TPixelEffect tEffect);
+	void SetEffect(uint32_t nOutput, TPixelEffect tEffect);
+	TPixelEffect GetEffect(uint32_t nOutput) const {
+		return nOutput < MAX_OUTPUTS ? m_aEffect[nOutput] : PIXEL_EFFECT_NONE;
+	}
+
+	/**
+	 * 0xRRGGBB, the white channel of RGBW LEDs is the lowest of the three
+	 */
+	void SetColour(uint32_t nColour) {
+		m_nColour = nColour;
+	}
+
+	void SetCycleMillis(uint32_t nCycleMillis);
+
+	bool IsEnabled() const;
+
+	/**
+	 * nCount pixels of nOutput starting at nFirstLed, out of nLedCount LEDs of the output
+	 */
+	void Render(uint32_t nOutput, uint8_t *pPixels, uint32_t nFirstLed, uint32_t nCount, uint32_t nLedCount, uint32_t nChannelsPerLed, uint32_t nMillis) const;
+
+	void Print();
+
+	static const char *GetEffectString(TPixelEffect tEffect);
+	static TPixelEffect GetEffect(const char *pString);
+
+private:
+	TPixelEffect m_aEffect[MAX_OUTPUTS];
+	uint32_t m_nColour{0xFFFFFF};
+	uint32_t m_nCycleMillis{CYCLE_MILLIS_DEFAULT};
+};
+
+#endif /* PIXELEFFECTS_H_ */
@@ -0,0 +1,80 @@
+/**
+ * @file pixeleffectsparams.h
+ *
+ */
+/* Copyright (C) 2020 by Arjan van Vught mailto:info@orangepi-dmx.nl
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#ifndef PIXELEFFECTSPARAMS_H_
+#define PIXELEFFECTSPARAMS_H_
+
+#include <stdint.h>
+
+#include "pixeleffects.h"
+
+struct TPixelEffectsParams {
+	uint32_t nSetList;
+	uint8_t nEffect;
+	uint8_t aEffect[PixelEffects::MAX_OUTPUTS];
+	uint32_t nColour;
+	uint16_t nCycleMillis;
+};
+
+struct PixelEffectsParamsMask {
+	static constexpr auto EFFECT = (1U << 0);
+	static constexpr auto COLOUR = (1U << 1);
+	static constexpr auto CYCLE_MS = (1U << 2);
+	static constexpr auto EFFECT_OUTPUT = (1U << 3);	///< effect_1 .. effect_8 are in the next bits
+};
+
+/**
+ * effects.txt, the failsafe scene on network data loss
+ *
+ *  effect=<none|solid|chase|rainbow|noise|breathe>	all outputs
+ *  effect_<1..8>=<effect>							a single output
+ *  colour=<RRGGBB>
+ *  cycle_ms=<1..65535>
+ */
+class PixelEffectsParams {
+public:
+	PixelEffectsParams();
+
+	bool Load();
+	void Load(const char *pBuffer, uint32_t nLength);
+
+	void Set(PixelEffects *pPixelEffects);
+
+	void Dump();
+
+public:
+	static void staticCallbackFunction(void *p, const char *s);
+
+private:
+	void callbackFunction(const char *pLine);
+	bool isMaskSet(uint32_t nMask) const {
+		return (m_tPixelEffectsParams.nSetList & nMask) == nMask;
+	}
+
+private:
+	struct TPixelEffectsParams m_tPixelEffectsParams;
+};
+
+#endif /* PIXELEFFECTSPARAMS_H_ */
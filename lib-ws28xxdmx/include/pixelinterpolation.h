@@ -0,0 +1,119 @@
+/**
+ * @file pixelinterpolation.h
+ *
+ */
+/* Copyright (C) 2020 by Arjan van Vught mailto:info@orangepi-dmx.nl
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#ifndef PIXELINTERPOLATION_H_
+#define PIXELINTERPOLATION_H_
+
+#include <stdint.h>
+
+/**
+ * Keeps the last two frames per port. On the output timer a frame between them is emitted,
+ * the weight is the time since the newest frame arrived over the interpolation delay.
+ */
+class PixelInterpolation {
+public:
+	static constexpr uint32_t DELAY_MILLIS_DEFAULT = 25;	///< 40Hz input
+
+	PixelInterpolation();
+	~PixelInterpolation();
+
+	/**
+	 * 0 disables the interpolation
+	 */
+	void SetOutputHz(uint32_t nOutputHz) {
+		m_nOutputHz = nOutputHz;
+	}
+	uint32_t GetOutputHz() const {
+		return m_nOutputHz;
+	}
+
+	void SetDelayMillis(uint32_t nDelayMillis) {
+		m_nDelayMillis = nDelayMillis;
+	}
+
+	void Setup(uint32_t nPorts);
+
+	bool IsEnabled() const {
+		return m_nPorts != 0;
+	}
+
+	void SetData(uint32_t nPort, const uint8_t *pData, uint32_t nLength, uint32_t nMicros);
+
+	/**
+	 * True when the output timer has expired
+	 */
+	bool IsOutputDue(uint32_t nMicros) {
+		if ((nMicros - m_nOutputMicros) < m_nOutputPeriodMicros) {
+			return false;
+		}
+
+		m_nOutputMicros = nMicros;
+		return true;
+	}
+
+	/**
+	 * The interpolated frame of nPort into pOut. Returns the length, 0 when the port is settled and bForce is false.
+	 */
+	uint32_t Get(uint32_t nPort, uint8_t *pOut, uint32_t nMicros, bool bForce = false);
+
+	/**
+	 * a + (b - a) * nWeight / 256, nWeight 0..256, 4 slots per iteration
+	 */
+	static void Blend(const uint8_t *pA, const uint8_t *pB, uint8_t *pOut, uint32_t nLength, uint32_t nWeight) {
+		const uint32_t *pA32 = reinterpret_cast<const uint32_t *>(pA);
+		const uint32_t *pB32 = reinterpret_cast<const uint32_t *>(pB);
+		uint32_t *pOut32 = reinterpret_cast<uint32_t *>(pOut);
+		const uint32_t nWeightA = 256 - nWeight;
+
+		for (uint32_t i = 0; i < ((nLength + 3) / 4); i++) {
+			const uint32_t a = pA32[i];
+			const uint32_t b = pB32[i];
+			// Two 8-bit slots in 16-bit lanes, 255 * 256 fits a lane
+			const uint32_t nEven = (((a & 0x00FF00FF) * nWeightA) + ((b & 0x00FF00FF) * nWeight)) >> 8;
+			const uint32_t nOdd = (((a >> 8) & 0x00FF00FF) * nWeightA) + (((b >> 8) & 0x00FF00FF) * nWeight);
+			pOut32[i] = (nEven & 0x00FF00FF) | (nOdd & 0xFF00FF00);
+		}
+	}
+
+	void Print();
+
+private:
+	struct TPort {
+		uint32_t nMicros;
+		uint16_t nLength;
+		uint8_t nCurrent;	///< Frame index 0 or 1
+		bool bSettled;
+	};
+
+	uint32_t m_nOutputHz{0};
+	uint32_t m_nDelayMillis{DELAY_MILLIS_DEFAULT};
+	uint32_t m_nOutputPeriodMicros{0};
+	uint32_t m_nOutputMicros{0};
+	uint32_t m_nPorts{0};
+	struct TPort *m_pPorts{nullptr};
+	uint8_t *m_pFrames{nullptr};	///< [port][2][DMX_UNIVERSE_SIZE]
+};
+
+#endif /* PIXELINTERPOLATION_H_ */
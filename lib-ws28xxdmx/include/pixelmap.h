@@ -0,0 +1,137 @@
+/**
+ * @file pixelmap.h
+ *
+ */
+/* Copyright (C) 2020 by Arjan van Vught mailto:info@orangepi-dmx.nl
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#ifndef PIXELMAP_H_
+#define PIXELMAP_H_
+
+#include <stdint.h>
+#include <cassert>
+
+#include "lightset.h"
+
+/**
+ * A run copies nCount consecutive pixels of a port (universe), starting at DMX slot nSlot,
+ * to nCount consecutive LEDs of an output, starting at nLed. A reversed run fills the LEDs from the end.
+ */
+struct TPixelMapRun {
+	uint16_t nSlot;		///< 0 based
+	uint16_t nPixelOffset;	///< Added to nSlot as pixels by Compile, when the channels per LED are known
+	uint16_t nLed;
+	uint16_t nCount;
+	uint8_t nPort;
+	uint8_t nOutput;
+	bool bReverse;
+};
+
+/**
+ * The runs are compiled once, sorted per port, so a port is handled with a few bulk encodes.
+ */
+class PixelMap {
+public:
+	static constexpr uint32_t MAX_RUNS = 256;
+	static constexpr uint32_t MAX_PORTS = 32;
+
+	PixelMap();
+
+	void Clear();
+	bool Add(const struct TPixelMapRun &tRun);
+
+	/**
+	 * Drops the runs not fitting the outputs, sorts the remaining per port.
+	 */
+	void Compile(uint32_t nOutputs, uint32_t nLedCount, uint32_t nChannelsPerLed);
+
+	bool IsEmpty() const {
+		return m_nRuns == 0;
+	}
+
+	uint32_t GetPortLast() const {
+		return m_nPortLast;
+	}
+
+	/**
+	 * Output must have SetLEDs(nOutput, nFirstLed, pData, nCount)
+	 */
+	template<class T>
+	void Run(T &Output, uint32_t nPort, const uint8_t *pData, uint32_t nLength, const struct TLightSetDirty &tDirty) const {
+		if ((nPort >= MAX_PORTS) || lightset::data::IsClean(tDirty)) {
+			return;
+		}
+
+		const uint32_t nLast = tDirty.nLast < nLength ? tDirty.nLast : nLength - 1;
+
+		for (uint32_t i = m_aPortFirst[nPort]; i < m_aPortFirst[nPort + 1]; i++) {
+			const struct TPixelMapRun &tRun = m_aRuns[i];
+
+			if ((tDirty.nFirst >= tRun.nSlot + (tRun.nCount * m_nChannelsPerLed)) || (nLast < tRun.nSlot) || (nLength < tRun.nSlot + m_nChannelsPerLed)) {
+				continue;
+			}
+
+			// The pixels of the run covering the changed slots, whole pixels within nLength only
+			const uint32_t nFirst = tDirty.nFirst > tRun.nSlot ? (tDirty.nFirst - tRun.nSlot) / m_nChannelsPerLed : 0;
+			uint32_t nEnd = 1 + ((nLast - tRun.nSlot) / m_nChannelsPerLed);
+			const uint32_t nWhole = (nLength - tRun.nSlot) / m_nChannelsPerLed;
+
+			nEnd = nEnd < tRun.nCount ? nEnd : tRun.nCount;
+			nEnd = nEnd < nWhole ? nEnd : nWhole;
+
+			if (nEnd <= nFirst) {
+				continue;
+			}
+
+			const uint8_t *pPixels = &pData[tRun.nSlot + (nFirst * m_nChannelsPerLed)];
+			const uint32_t nCount = nEnd - nFirst;
+
+			if (!tRun.bReverse) {
+				Output.SetLEDs(tRun.nOutput, tRun.nLed + nFirst, pPixels, nCount);
+				continue;
+			}
+
+			uint8_t aReversed[DMX_UNIVERSE_SIZE];
+			uint8_t *pReversed = &aReversed[(nCount - 1) * m_nChannelsPerLed];
+
+			for (uint32_t k = 0; k < nCount; k++) {
+				for (uint32_t c = 0; c < m_nChannelsPerLed; c++) {
+					pReversed[c] = pPixels[c];
+				}
+				pPixels += m_nChannelsPerLed;
+				pReversed -= m_nChannelsPerLed;
+			}
+
+			Output.SetLEDs(tRun.nOutput, tRun.nLed + tRun.nCount - nEnd, aReversed, nCount);
+		}
+	}
+
+	void Dump();
+
+private:
+	struct TPixelMapRun m_aRuns[MAX_RUNS];
+	uint32_t m_nRuns{0};
+	uint32_t m_aPortFirst[MAX_PORTS + 1];	///< The runs of port n are [m_aPortFirst[n], m_aPortFirst[n + 1])
+	uint32_t m_nPortLast{0};
+	uint32_t m_nChannelsPerLed{3};
+};
+
+#endif /* PIXELMAP_H_ */
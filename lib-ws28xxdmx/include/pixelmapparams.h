@@ -0,0 +1,70 @@
+/**
+ * @file pixelmapparams.h
+ *
+ */
+/* Copyright (C) 2020 by Arjan van Vught mailto:info@orangepi-dmx.nl
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#ifndef PIXELMAPPARAMS_H_
+#define PIXELMAPPARAMS_H_
+
+#include <stdint.h>
+
+#include "pixelmap.h"
+
+/**
+ * pixelmap.txt
+ *
+ *  run=<port>,<slot>,<output>,<led>,<count>[,r]
+ *   <count> pixels of <port>, starting at DMX slot <slot> (1..512), to the LEDs <led>.. of <output>.
+ *   With ',r' the LEDs are filled from the end.
+ *
+ *  zigzag=<port>,<slot>,<output>,<led>,<width>,<rows>
+ *   A serpentine matrix: a run per row of <width> pixels, every other row reversed.
+ */
+class PixelMapParams {
+public:
+	PixelMapParams();
+
+	bool Load();
+	void Load(const char *pBuffer, uint32_t nLength);
+
+	void Set(PixelMap *pPixelMap);
+
+	void Dump();
+
+	uint32_t GetRuns() const {
+		return m_nRuns;
+	}
+
+public:
+	static void staticCallbackFunction(void *p, const char *s);
+
+private:
+	void callbackFunction(const char *pLine);
+	void Add(const struct TPixelMapRun &tRun);
+
+private:
+	struct TPixelMapRun m_aRuns[PixelMap::MAX_RUNS];
+	uint32_t m_nRuns{0};
+};
+
+#endif /* PIXELMAPPARAMS_H_ */
@@ -32,6 +32,9 @@
 
 #include "ws28xx.h"
 #include "ws28xxdmxstore.h"
+#include "pixelcorrection.h"
+#include "pixelinterpolation.h"
+#include "pixeleffects.h"
 
 class WS28xxDmx: public LightSet {
 public:
@@ -42,6 +45,16 @@ public:
 	void Stop(uint8_t nPort = 0) override;
 
 	void SetData(uint8_t nPort, const uint8_t*, uint16_t) override;
+	void SetDataRange(uint8_t nPort, const uint8_t*, uint16_t, const struct TLightSetDirty&) override;
+
+	void FrameBegin() override;
+	void FrameCommit() override;
+
+	/**
+	 * With temporal dithering an idle output re-sends the retained input.
+	 * After Stop with effects enabled, the output runs the failsafe scene.
+	 */
+	void FrameRun() override;
 
 	void Blackout(bool bBlackout);
 
@@ -67,6 +80,10 @@ public:
 		return m_nLedCount;
 	}
 
+	uint32_t GetUniverses() const {
+		return m_nPortIdLast + 1;
+	}
+
 	void SetClockSpeedHz(uint32_t nClockSpeedHz) {
 		m_nClockSpeedHz = nClockSpeedHz;
 	}
@@ -83,6 +100,33 @@ public:
 		return m_nGlobalBrightness;
 	}
 
+	void SetGamma(float fGamma) {
+		m_Correction.SetGamma(fGamma);
+	}
+
+	void SetWhiteBalance(uint8_t nRed, uint8_t nGreen, uint8_t nBlue, uint8_t nWhite) {
+		m_Correction.SetWhiteBalance(nRed, nGreen, nBlue, nWhite);
+	}
+
+	void SetDither(bool bDither) {
+		m_Correction.SetDither(bDither);
+	}
+
+	/**
+	 * With nOutputHz != 0 the output is driven by FrameRun, interpolating between the last two frames over nDelayMillis
+	 */
+	void SetInterpolation(uint32_t nOutputHz, uint32_t nDelayMillis) {
+		m_Interpolation.SetOutputHz(nOutputHz);
+		m_Interpolation.SetDelayMillis(nDelayMillis);
+	}
+
+	/**
+	 * On Stop (network data loss) output 1 of the effects runs until Start, nullptr blacks out
+	 */
+	void SetPixelEffects(PixelEffects *pPixelEffects) {
+		m_pPixelEffects = pPixelEffects;
+	}
+
 	void SetWS28xxDmxStore(WS28xxDmxStore *pWS28xxDmxStore) {
 		m_pWS28xxDmxStore = pWS28xxDmxStore;
 	}
@@ -104,6 +148,19 @@ public: // RDM
 
 private:
 	void UpdateMembers();
+	void Encode(uint8_t nPortId, const uint8_t *pData, uint16_t nLength, const struct TLightSetDirty &tDirty);
+	void RunInterpolation();
+
+protected:
+	/**
+	 * After Stop with effects enabled, renders the next frame of the failsafe scene when due
+	 */
+	void RunFailsafe();
+
+	/**
+	 * Encodes nCount pixels through the correction stage
+	 */
+	void SetLEDs(uint32_t nFirstLed, const uint8_t *pData, uint32_t nCount);
 
 protected:
 	TWS28XXType m_tLedType;
@@ -122,15 +179,23 @@ protected:
 
 	WS28xxDmxStore *m_pWS28xxDmxStore;
 
+	PixelCorrection m_Correction;
+	PixelInterpolation m_Interpolation;
+
 private:
+	static constexpr uint32_t FAILSAFE_FRAME_MILLIS = 20;
+
+	PixelEffects *m_pPixelEffects{nullptr};
+	bool m_bFailsafe{false};
+	uint32_t m_nFailsafeMillis{0};
+
 	uint32_t m_nClockSpeedHz;
 	uint8_t m_nGlobalBrightness;
-	uint32_t m_nBeginIndexPortId1;
-	uint32_t m_nBeginIndexPortId2;
-	uint32_t m_nBeginIndexPortId3;
+	uint32_t m_nLedsPerUniverse;
 	uint32_t m_nChannelsPerLed;
 
 	uint32_t m_nPortIdLast;
+	bool m_bFrameCommit{false};	///< The caller drives FrameBegin / FrameCommit, m_nPortIdLast is not used
 };
 
 #endif /* WS28XXDMX_H_ */
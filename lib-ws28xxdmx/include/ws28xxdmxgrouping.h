@@ -39,6 +39,20 @@ public:
 	void Start(uint8_t nPort = 0) override;
 
 	void SetData(uint8_t nPort, const uint8_t *pData, uint16_t nLenght) override;
+	// The group is always set as a whole
+	void SetDataRange(uint8_t nPort, const uint8_t *pData, uint16_t nLength, const struct TLightSetDirty &tDirty) override {
+		(void)tDirty;
+		SetData(nPort, pData, nLength);
+	}
+	// A single universe, the output is updated with each SetData
+	void FrameBegin() override {
+	}
+	void FrameCommit() override {
+	}
+	// The group colour is corrected without temporal dithering, only the failsafe scene runs here
+	void FrameRun() override {
+		RunFailsafe();
+	}
 
 	void SetLEDType(TWS28XXType tLedType) override;
 	void SetLEDCount(uint16_t nLedCount) override;
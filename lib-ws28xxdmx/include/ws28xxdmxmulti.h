@@ -31,6 +31,10 @@
 #include "lightset.h"
 
 #include "ws28xxmulti.h"
+#include "pixelmap.h"
+#include "pixelcorrection.h"
+#include "pixelinterpolation.h"
+#include "pixeleffects.h"
 
 #include "rgbmapping.h"
 
@@ -50,9 +54,30 @@ public:
 	void Stop(uint8_t nPort) override;
 
 	void SetData(uint8_t nPort, const uint8_t *pData, uint16_t nLength) override;
+	void SetDataRange(uint8_t nPort, const uint8_t *pData, uint16_t nLength, const struct TLightSetDirty &tDirty) override;
+
+	void FrameBegin() override;
+	void FrameCommit() override;
+
+	/**
+	 * Starts a waiting frame. With temporal dithering an idle output re-sends the retained input.
+	 * After Stop with effects enabled, the outputs run the failsafe scene.
+	 */
+	void FrameRun() override;
+
+	/**
+	 * Encodes nCount pixels of the output through the correction stage, each pixel on nGroupCount LEDs
+	 */
+	void SetLEDs(uint8_t nOutput, uint32_t nFirstLed, const uint8_t *pData, uint32_t nCount, uint32_t nGroupCount = 1);
 
 	void Blackout(bool bBlackout);
 
+	/**
+	 * Replaces the linear port -> output mapping, call after Initialize.
+	 * The map is compiled against the outputs, nullptr restores the linear mapping.
+	 */
+	void SetPixelMap(PixelMap *pPixelMap);
+
 	virtual void SetLEDType(TWS28XXType tWS28xxMultiType);
 	TWS28XXType GetLEDType() {
 		if (m_pLEDStripe != nullptr) {
@@ -78,6 +103,14 @@ public:
 		return m_nLedCount;
 	}
 
+	/**
+	 * With nLedGroupCount > 1 an output takes a single universe, each pixel is set on nLedGroupCount LEDs
+	 */
+	void SetLEDGroupCount(uint16_t nLedGroupCount);
+	uint32_t GetLEDGroupCount() {
+		return m_nLedGroupCount;
+	}
+
 	void SetActivePorts(uint8_t nActiveOutputs);
 	uint32_t GetActivePorts() {
 		return m_nActiveOutputs;
@@ -87,6 +120,33 @@ public:
 		return m_nUniverses;
 	}
 
+	void SetGamma(float fGamma) {
+		m_Correction.SetGamma(fGamma);
+	}
+
+	void SetWhiteBalance(uint8_t nRed, uint8_t nGreen, uint8_t nBlue, uint8_t nWhite) {
+		m_Correction.SetWhiteBalance(nRed, nGreen, nBlue, nWhite);
+	}
+
+	void SetDither(bool bDither) {
+		m_Correction.SetDither(bDither);
+	}
+
+	/**
+	 * With nOutputHz != 0 the output is driven by FrameRun, interpolating between the last two frames over nDelayMillis
+	 */
+	void SetInterpolation(uint32_t nOutputHz, uint32_t nDelayMillis) {
+		m_Interpolation.SetOutputHz(nOutputHz);
+		m_Interpolation.SetDelayMillis(nDelayMillis);
+	}
+
+	/**
+	 * On Stop (network data loss) the outputs run the effects until Start, nullptr blacks out
+	 */
+	void SetPixelEffects(PixelEffects *pPixelEffects) {
+		m_pPixelEffects = pPixelEffects;
+	}
+
 	void SetUseSI5351A(bool bUse) {
 		m_bUseSI5351A = bUse;
 	}
@@ -94,6 +154,10 @@ public:
 		return m_bUseSI5351A;
 	}
 
+	uint32_t GetFramesDropped() const {
+		return m_pLEDStripe->GetFramesDropped();
+	}
+
 	WS28xxMultiBoard GetBoard() {
 		if (m_pLEDStripe != nullptr) {
 			return m_pLEDStripe->GetBoard();
@@ -105,8 +169,14 @@ public:
 
 private:
 	void UpdateMembers();
+	void Encode(uint8_t nPortId, const uint8_t *pData, uint16_t nLength, const struct TLightSetDirty &tDirty);
+	void RunInterpolation();
+	void RunFailsafe();
 
 private:
+	static constexpr uint32_t FAILSAFE_FRAME_MILLIS = 20;
+
+
 	TWS28xxDmxMultiSrc m_tSrc;
 	TWS28XXType m_tLedType;
 
@@ -118,18 +188,27 @@ private:
 	uint32_t m_nActiveOutputs;
 
 	WS28xxMulti *m_pLEDStripe;
+	PixelMap *m_pPixelMap{nullptr};
+	PixelCorrection m_Correction;
+	PixelInterpolation m_Interpolation;
+	PixelEffects *m_pPixelEffects{nullptr};
 
 	bool m_bIsStarted;
+	bool m_bFailsafe{false};
+	uint32_t m_nFailsafeMillis{0};
 	bool m_bBlackout;
 
 	uint32_t m_nUniverses;
+	uint32_t m_nPortsPerOutput;		///< Art-Net has 4 ports per output, for sACN it is m_nUniverses
 
-	uint32_t m_nBeginIndexPortId1;
-	uint32_t m_nBeginIndexPortId2;
-	uint32_t m_nBeginIndexPortId3;
+	uint32_t m_nLedsPerUniverse;
 	uint32_t m_nChannelsPerLed;
 
+	uint32_t m_nLedGroupCount{1};
+	uint32_t m_nGroups{0};
+
 	uint32_t m_nPortIdLast;
+	bool m_bFrameCommit{false};	///< The caller drives FrameBegin / FrameCommit, m_nPortIdLast is not used
 	bool m_bUseSI5351A;
 };
 
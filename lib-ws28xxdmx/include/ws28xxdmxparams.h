@@ -48,6 +48,11 @@ struct TWS28xxDmxParams {
 	uint8_t nRgbMapping;
 	uint8_t nLowCode;
 	uint8_t nHighCode;
+	uint8_t nGamma;			///< x10
+	uint8_t aBalance[4];	///< R, G, B, W
+	bool bDither;
+	uint8_t nInterpolationMillis;
+	uint16_t nInterpolationHz;
 };
 
 struct WS28xxDmxParamsMask {
@@ -63,6 +68,11 @@ struct WS28xxDmxParamsMask {
 	static constexpr auto RGB_MAPPING = (1U << 9);
 	static constexpr auto LOW_CODE = (1U << 10);
 	static constexpr auto HIGH_CODE = (1U << 11);
+	static constexpr auto GAMMA = (1U << 12);
+	static constexpr auto BALANCE = (1U << 13);
+	static constexpr auto DITHER = (1U << 14);
+	static constexpr auto INTERPOLATION_HZ = (1U << 15);
+	static constexpr auto INTERPOLATION_MS = (1U << 16);
 };
 
 class WS28xxDmxParamsStore {
@@ -138,6 +148,14 @@ public:
 		return WS28xx::ConvertTxH(m_tWS28xxParams.nHighCode);
 	}
 
+	float GetGamma() const {
+		return static_cast<float>(m_tWS28xxParams.nGamma) / 10.0f;
+	}
+
+	bool IsDither() const {
+		return m_tWS28xxParams.bDither;
+	}
+
 public:
 	static void staticCallbackFunction(void *p, const char *s);
 
@@ -0,0 +1,215 @@
+/**
+ * @file pixelcorrection.cpp
+ *
+ */
+/* Copyright (C) 2020 by Arjan van Vught mailto:info@orangepi-dmx.nl
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <cassert>
+
+#include "pixelcorrection.h"
+
+#include "lightset.h"
+
+#include "debug.h"
+
+namespace pixelcorrection {
+/**
+ * Bit reversed 4-bit counter, the thresholds are spread evenly over 16 frames
+ */
+static constexpr uint8_t s_aThreshold[16] = {
+	0x08, 0x88, 0x48, 0xC8, 0x28, 0xA8, 0x68, 0xE8,
+	0x18, 0x98, 0x58, 0xD8, 0x38, 0xB8, 0x78, 0xF8
+};
+
+/**
+ * x^y for 0 <= x <= 1, there is no libm for the bare metal targets.
+ * Configuration time only.
+ */
+static double power(double x, double y) {
+	if (x <= 0) {
+		return 0;
+	}
+
+	// ln(x) = e * ln(2) + ln(m), 1 <= m < 2
+	int32_t e = 0;
+
+	while (x < 1) {
+		x *= 2;
+		e--;
+	}
+
+	const double z = (x - 1) / (x + 1);
+	const double z2 = z * z;
+	double fTerm = z;
+	double fLn = 0;
+
+	for (uint32_t n = 1; n < 24; n += 2) {
+		fLn += fTerm / n;
+		fTerm *= z2;
+	}
+
+	const double t = ((2 * fLn) + (e * 0.693147180559945309417)) * y;
+
+	// exp(t) = exp(t / 256)^256
+	const double r = t / 256;
+	double fExp = 1 + r * (1 + r / 2 * (1 + r / 3 * (1 + r / 4 * (1 + r / 5))));
+
+	for (uint32_t i = 0; i < 8; i++) {
+		fExp *= fExp;
+	}
+
+	return fExp;
+}
+}  // namespace pixelcorrection
+
+using namespace pixelcorrection;
+
+PixelCorrection::PixelCorrection() {
+	memset(m_aWhiteBalance, 0xFF, sizeof(m_aWhiteBalance));
+	Generate();
+}
+
+PixelCorrection::~PixelCorrection() {
+	delete[] m_pRetained;
+	m_pRetained = nullptr;
+
+	delete[] m_pRetainedLength;
+	m_pRetainedLength = nullptr;
+}
+
+void PixelCorrection::SetWhiteBalance(uint8_t nRed, uint8_t nGreen, uint8_t nBlue, uint8_t nWhite) {
+	m_aWhiteBalance[0] = nRed;
+	m_aWhiteBalance[1] = nGreen;
+	m_aWhiteBalance[2] = nBlue;
+	m_aWhiteBalance[3] = nWhite;
+}
+
+void PixelCorrection::Generate() {
+	DEBUG_ENTRY
+
+	if ((m_fGamma < 0.1f) || (m_fGamma > 5.0f)) {
+		m_fGamma = GAMMA_DEFAULT;
+	}
+
+	m_bEnabled = (m_fGamma != GAMMA_DEFAULT);
+
+	for (uint32_t nChannel = 0; nChannel < MAX_CHANNELS; nChannel++) {
+		const float fScale = static_cast<float>(m_aWhiteBalance[nChannel]) * (static_cast<float>(0xFF00) / 255.0f);
+
+		m_bEnabled |= (m_aWhiteBalance[nChannel] != 0xFF);
+
+		for (uint32_t i = 0; i < 256; i++) {
+			const float f = static_cast<float>(power(static_cast<double>(i) / 255, static_cast<double>(m_fGamma))) * fScale;
+			uint32_t nValue16 = static_cast<uint32_t>(f + 0.5f);
+
+			if (nValue16 > 0xFF00) {
+				nValue16 = 0xFF00;
+			}
+
+			m_aLut16[nChannel][i] = static_cast<uint16_t>(nValue16);
+			m_aLut[nChannel][i] = static_cast<uint8_t>((nValue16 + 0x80) >> 8);
+		}
+	}
+
+	DEBUG_PRINTF("m_bEnabled=%d, m_bDither=%d", m_bEnabled, m_bDither);
+	DEBUG_EXIT
+}
+
+void PixelCorrection::ApplyDither(const uint8_t *pIn, uint8_t *pOut, uint32_t nFirstLed, uint32_t nCount, uint32_t nChannelsPerLed) const {
+	// The threshold moves with the frame and the LED, neighbouring LEDs do not change in the same frame
+	uint32_t nIndex = m_nFrame + nFirstLed;
+
+	for (uint32_t i = 0; i < nCount; i++) {
+		const uint32_t nThreshold = s_aThreshold[nIndex++ & 0xF];
+
+		for (uint32_t nChannel = 0; nChannel < nChannelsPerLed; nChannel++) {
+			pOut[nChannel] = static_cast<uint8_t>((m_aLut16[nChannel][pIn[nChannel]] + nThreshold) >> 8);
+		}
+
+		pIn += nChannelsPerLed;
+		pOut += nChannelsPerLed;
+	}
+}
+
+void PixelCorrection::SetupRetain(uint32_t nPorts) {
+	DEBUG_ENTRY
+
+	if (nPorts == m_nRetainedPorts) {
+		DEBUG_EXIT
+		return;
+	}
+
+	delete[] m_pRetained;
+	delete[] m_pRetainedLength;
+
+	m_pRetained = new uint8_t[nPorts * DMX_UNIVERSE_SIZE];
+	assert(m_pRetained != nullptr);
+
+	m_pRetainedLength = new uint16_t[nPorts];
+	assert(m_pRetainedLength != nullptr);
+
+	memset(m_pRetainedLength, 0, nPorts * sizeof(uint16_t));
+
+	m_nRetainedPorts = nPorts;
+
+	DEBUG_PRINTF("m_nRetainedPorts=%d", static_cast<int>(m_nRetainedPorts));
+	DEBUG_EXIT
+}
+
+void PixelCorrection::Retain(uint32_t nPort, const uint8_t *pData, uint32_t nLength) {
+	assert(nLength <= DMX_UNIVERSE_SIZE);
+
+	if (nPort >= m_nRetainedPorts) {
+		return;
+	}
+
+	uint8_t *pRetained = &m_pRetained[nPort * DMX_UNIVERSE_SIZE];
+
+	if (pRetained != pData) {
+		memcpy(pRetained, pData, nLength);
+	}
+
+	m_pRetainedLength[nPort] = static_cast<uint16_t>(nLength);
+}
+
+const uint8_t *PixelCorrection::GetRetained(uint32_t nPort, uint32_t &nLength) const {
+	if (nPort >= m_nRetainedPorts) {
+		nLength = 0;
+		return nullptr;
+	}
+
+	nLength = m_pRetainedLength[nPort];
+	return &m_pRetained[nPort * DMX_UNIVERSE_SIZE];
+}
+
+void PixelCorrection::Print() {
+	if (!m_bEnabled) {
+		return;
+	}
+
+	printf(" Gamma   : %.1f\n", m_fGamma);
+	printf(" Balance : %d,%d,%d,%d\n", m_aWhiteBalance[0], m_aWhiteBalance[1], m_aWhiteBalance[2], m_aWhiteBalance[3]);
+	printf(" Dither  : %c\n", m_bDither ? 'Y' : 'N');
+}
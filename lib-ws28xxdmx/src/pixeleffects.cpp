@@ -0,0 +1,227 @@
+/**
+ * @file pixeleffects.cpp
+ *
+ */
+/* Copyright (C) 2020 by Arjan van Vught mailto:info@orangepi-dmx.nl
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <cassert>
+
+#include "pixeleffects.h"
+
+#include "debug.h"
+
+namespace pixeleffects {
+static constexpr char s_aEffects[PIXEL_EFFECT_UNDEFINED][8] = { "none", "solid", "chase", "rainbow", "noise", "breathe" };
+
+static uint32_t hash(uint32_t x) {
+	x ^= x >> 16;
+	x *= 0x7FEB352D;
+	x ^= x >> 15;
+	x *= 0x846CA68B;
+	x ^= x >> 16;
+	return x;
+}
+
+/**
+ * nHue 0..65535 at full saturation and value
+ */
+static void hue2rgb(uint32_t nHue, uint32_t &nRed, uint32_t &nGreen, uint32_t &nBlue) {
+	const uint32_t nSector = (nHue * 6) >> 16;
+	const uint32_t nRise = (((nHue * 6) & 0xFFFF) * 255) >> 16;
+	const uint32_t nFall = 255 - nRise;
+
+	switch (nSector) {
+	case 0:
+		nRed = 255; nGreen = nRise; nBlue = 0;
+		break;
+	case 1:
+		nRed = nFall; nGreen = 255; nBlue = 0;
+		break;
+	case 2:
+		nRed = 0; nGreen = 255; nBlue = nRise;
+		break;
+	case 3:
+		nRed = 0; nGreen = nFall; nBlue = 255;
+		break;
+	case 4:
+		nRed = nRise; nGreen = 0; nBlue = 255;
+		break;
+	default:
+		nRed = 255; nGreen = 0; nBlue = nFall;
+		break;
+	}
+}
+}  // namespace pixeleffects
+
+using namespace pixeleffects;
+
+PixelEffects::PixelEffects() {
+	for (uint32_t i = 0; i < MAX_OUTPUTS; i++) {
+		m_aEffect[i] = PIXEL_EFFECT_NONE;
+	}
+}
+
+void PixelEffects::SetEffect(TPixelEffect tEffect) {
+	for (uint32_t i = 0; i < MAX_OUTPUTS; i++) {
+		m_aEffect[i] = tEffect;
+	}
+}
+
+void PixelEffects::SetEffect(uint32_t nOutput, TPixelEffect tEffect) {
+	if (nOutput < MAX_OUTPUTS) {
+		m_aEffect[nOutput] = tEffect;
+	}
+}
+
+void PixelEffects::SetCycleMillis(uint32_t nCycleMillis) {
+	if ((nCycleMillis == 0) || (nCycleMillis > 0xFFFF)) {
+		m_nCycleMillis = CYCLE_MILLIS_DEFAULT;
+		return;
+	}
+
+	m_nCycleMillis = nCycleMillis;
+}
+
+bool PixelEffects::IsEnabled() const {
+	for (uint32_t i = 0; i < MAX_OUTPUTS; i++) {
+		if (m_aEffect[i] != PIXEL_EFFECT_NONE) {
+			return true;
+		}
+	}
+
+	return false;
+}
+
+void PixelEffects::Render(uint32_t nOutput, uint8_t *pPixels, uint32_t nFirstLed, uint32_t nCount, uint32_t nLedCount, uint32_t nChannelsPerLed, uint32_t nMillis) const {
+	assert(pPixels != nullptr);
+	assert((nChannelsPerLed == 3) || (nChannelsPerLed == 4));
+
+	const TPixelEffect tEffect = GetEffect(nOutput);
+
+	if ((tEffect == PIXEL_EFFECT_NONE) || (nLedCount == 0)) {
+		memset(pPixels, 0, nCount * nChannelsPerLed);
+		return;
+	}
+
+	// 16-bit phase within the cycle
+	const uint32_t nCycle = nMillis / m_nCycleMillis;
+	const uint32_t nPhase = ((nMillis - (nCycle * m_nCycleMillis)) << 16) / m_nCycleMillis;
+
+	const uint32_t nRed = (m_nColour >> 16) & 0xFF;
+	const uint32_t nGreen = (m_nColour >> 8) & 0xFF;
+	const uint32_t nBlue = m_nColour & 0xFF;
+
+	// 16.16 steps along the output
+	const uint32_t nHueStep = 0x10000 / nLedCount;
+	const uint32_t nHead = (nPhase * nLedCount) >> 16;
+	const uint32_t nTail = (nLedCount / 8) + 1;
+
+	uint32_t nBreathe = nPhase < 0x8000 ? (nPhase >> 7) : ((0xFFFF - nPhase) >> 7);
+	nBreathe = (nBreathe * nBreathe) >> 8;
+
+	for (uint32_t i = 0, nLed = nFirstLed; i < nCount; i++, nLed++) {
+		uint32_t r, g, b, nLevel;
+
+		switch (tEffect) {
+		case PIXEL_EFFECT_CHASE: {
+			const uint32_t nDistance = (nHead + nLedCount - nLed) % nLedCount;
+			nLevel = nDistance < nTail ? 255 - ((nDistance * 255) / nTail) : 0;
+			r = (nRed * nLevel) >> 8;
+			g = (nGreen * nLevel) >> 8;
+			b = (nBlue * nLevel) >> 8;
+		}
+			break;
+		case PIXEL_EFFECT_RAINBOW:
+			hue2rgb((nPhase + (nLed * nHueStep)) & 0xFFFF, r, g, b);
+			break;
+		case PIXEL_EFFECT_NOISE: {
+			// Value noise, each LED fades between two random levels per cycle
+			const uint32_t nFrom = hash((nLed << 16) ^ nCycle) & 0xFF;
+			const uint32_t nTo = hash((nLed << 16) ^ (nCycle + 1)) & 0xFF;
+			nLevel = ((nFrom * (0x10000 - nPhase)) + (nTo * nPhase)) >> 16;
+			r = (nRed * nLevel) >> 8;
+			g = (nGreen * nLevel) >> 8;
+			b = (nBlue * nLevel) >> 8;
+		}
+			break;
+		case PIXEL_EFFECT_BREATHE:
+			r = (nRed * nBreathe) >> 8;
+			g = (nGreen * nBreathe) >> 8;
+			b = (nBlue * nBreathe) >> 8;
+			break;
+		default:	// PIXEL_EFFECT_SOLID
+			r = nRed;
+			g = nGreen;
+			b = nBlue;
+			break;
+		}
+
+		pPixels[0] = static_cast<uint8_t>(r);
+		pPixels[1] = static_cast<uint8_t>(g);
+		pPixels[2] = static_cast<uint8_t>(b);
+
+		if (nChannelsPerLed == 4) {
+			uint32_t w = r < g ? r : g;
+			w = w < b ? w : b;
+			pPixels[3] = static_cast<uint8_t>(w);
+		}
+
+		pPixels += nChannelsPerLed;
+	}
+}
+
+const char *PixelEffects::GetEffectString(TPixelEffect tEffect) {
+	if (tEffect < PIXEL_EFFECT_UNDEFINED) {
+		return s_aEffects[tEffect];
+	}
+
+	return "Unknown";
+}
+
+TPixelEffect PixelEffects::GetEffect(const char *pString) {
+	assert(pString != nullptr);
+
+	for (uint32_t i = 0; i < PIXEL_EFFECT_UNDEFINED; i++) {
+		if (strcasecmp(pString, s_aEffects[i]) == 0) {
+			return static_cast<TPixelEffect>(i);
+		}
+	}
+
+	return PIXEL_EFFECT_UNDEFINED;
+}
+
+void PixelEffects::Print() {
+	if (!IsEnabled()) {
+		return;
+	}
+
+	printf(" Failsafe: %06X, %dms\n", static_cast<int>(m_nColour), static_cast<int>(m_nCycleMillis));
+
+	for (uint32_t i = 0; i < MAX_OUTPUTS; i++) {
+		if (m_aEffect[i] != PIXEL_EFFECT_NONE) {
+			printf("  %d: %s\n", static_cast<int>(i + 1), s_aEffects[m_aEffect[i]]);
+		}
+	}
+}
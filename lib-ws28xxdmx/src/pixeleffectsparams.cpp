@@ -0,0 +1,177 @@
+/**
+ * @file pixeleffectsparams.cpp
+ *
+ */
+/* Copyright (C) 2020 by Arjan van Vught mailto:info@orangepi-dmx.nl
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#if !defined(__clang__)	// Needed for compiling on MacOS
+# pragma GCC push_options
+# pragma GCC optimize ("Os")
+#endif
+
+#include <stdint.h>
+#include <string.h>
+#ifndef NDEBUG
+ #include <stdio.h>
+#endif
+#include <cassert>
+
+#include "pixeleffectsparams.h"
+#include "pixeleffectsparamsconst.h"
+#include "pixeleffects.h"
+
+#include "readconfigfile.h"
+#include "sscan.h"
+
+PixelEffectsParams::PixelEffectsParams() {
+	m_tPixelEffectsParams.nSetList = 0;
+	m_tPixelEffectsParams.nEffect = PIXEL_EFFECT_NONE;
+	memset(m_tPixelEffectsParams.aEffect, PIXEL_EFFECT_NONE, sizeof(m_tPixelEffectsParams.aEffect));
+	m_tPixelEffectsParams.nColour = 0xFFFFFF;
+	m_tPixelEffectsParams.nCycleMillis = PixelEffects::CYCLE_MILLIS_DEFAULT;
+}
+
+bool PixelEffectsParams::Load() {
+	m_tPixelEffectsParams.nSetList = 0;
+
+	ReadConfigFile configfile(PixelEffectsParams::staticCallbackFunction, this);
+
+	return configfile.Read(PixelEffectsParamsConst::FILE_NAME);
+}
+
+void PixelEffectsParams::Load(const char *pBuffer, uint32_t nLength) {
+	assert(pBuffer != nullptr);
+	assert(nLength != 0);
+
+	m_tPixelEffectsParams.nSetList = 0;
+
+	ReadConfigFile config(PixelEffectsParams::staticCallbackFunction, this);
+
+	config.Read(pBuffer, nLength);
+}
+
+void PixelEffectsParams::callbackFunction(const char *pLine) {
+	assert(pLine != nullptr);
+
+	uint16_t nValue16;
+	uint32_t nValue32;
+	char cBuffer[8];
+
+	uint32_t nLength = sizeof(cBuffer) - 1;
+
+	if (Sscan::Char(pLine, PixelEffectsParamsConst::EFFECT, cBuffer, nLength) == Sscan::OK) {
+		cBuffer[nLength] = '\0';
+		const TPixelEffect tEffect = PixelEffects::GetEffect(cBuffer);
+
+		if (tEffect != PIXEL_EFFECT_UNDEFINED) {
+			m_tPixelEffectsParams.nEffect = static_cast<uint8_t>(tEffect);
+			m_tPixelEffectsParams.nSetList |= PixelEffectsParamsMask::EFFECT;
+		}
+		return;
+	}
+
+	for (uint32_t i = 0; i < PixelEffects::MAX_OUTPUTS; i++) {
+		nLength = sizeof(cBuffer) - 1;
+
+		if (Sscan::Char(pLine, PixelEffectsParamsConst::EFFECT_OUTPUT[i], cBuffer, nLength) == Sscan::OK) {
+			cBuffer[nLength] = '\0';
+			const TPixelEffect tEffect = PixelEffects::GetEffect(cBuffer);
+
+			if (tEffect != PIXEL_EFFECT_UNDEFINED) {
+				m_tPixelEffectsParams.aEffect[i] = static_cast<uint8_t>(tEffect);
+				m_tPixelEffectsParams.nSetList |= (PixelEffectsParamsMask::EFFECT_OUTPUT << i);
+			}
+			return;
+		}
+	}
+
+	if (Sscan::Hex24Uint32(pLine, PixelEffectsParamsConst::COLOUR, nValue32) == Sscan::OK) {
+		m_tPixelEffectsParams.nColour = nValue32;
+		m_tPixelEffectsParams.nSetList |= PixelEffectsParamsMask::COLOUR;
+		return;
+	}
+
+	if (Sscan::Uint16(pLine, PixelEffectsParamsConst::CYCLE_MS, nValue16) == Sscan::OK) {
+		if (nValue16 != 0) {
+			m_tPixelEffectsParams.nCycleMillis = nValue16;
+			m_tPixelEffectsParams.nSetList |= PixelEffectsParamsMask::CYCLE_MS;
+		}
+		return;
+	}
+}
+
+void PixelEffectsParams::Set(PixelEffects *pPixelEffects) {
+	assert(pPixelEffects != nullptr);
+
+	if (isMaskSet(PixelEffectsParamsMask::EFFECT)) {
+		pPixelEffects->SetEffect(static_cast<TPixelEffect>(m_tPixelEffectsParams.nEffect));
+	}
+
+	for (uint32_t i = 0; i < PixelEffects::MAX_OUTPUTS; i++) {
+		if (isMaskSet(PixelEffectsParamsMask::EFFECT_OUTPUT << i)) {
+			pPixelEffects->SetEffect(i, static_cast<TPixelEffect>(m_tPixelEffectsParams.aEffect[i]));
+		}
+	}
+
+	if (isMaskSet(PixelEffectsParamsMask::COLOUR)) {
+		pPixelEffects->SetColour(m_tPixelEffectsParams.nColour);
+	}
+
+	if (isMaskSet(PixelEffectsParamsMask::CYCLE_MS)) {
+		pPixelEffects->SetCycleMillis(m_tPixelEffectsParams.nCycleMillis);
+	}
+}
+
+void PixelEffectsParams::Dump() {
+#ifndef NDEBUG
+	if (m_tPixelEffectsParams.nSetList == 0) {
+		return;
+	}
+
+	printf("%s::%s \'%s\':\n", __FILE__, __FUNCTION__, PixelEffectsParamsConst::FILE_NAME);
+
+	if (isMaskSet(PixelEffectsParamsMask::EFFECT)) {
+		printf(" %s=%s\n", PixelEffectsParamsConst::EFFECT, PixelEffects::GetEffectString(static_cast<TPixelEffect>(m_tPixelEffectsParams.nEffect)));
+	}
+
+	for (uint32_t i = 0; i < PixelEffects::MAX_OUTPUTS; i++) {
+		if (isMaskSet(PixelEffectsParamsMask::EFFECT_OUTPUT << i)) {
+			printf(" %s=%s\n", PixelEffectsParamsConst::EFFECT_OUTPUT[i], PixelEffects::GetEffectString(static_cast<TPixelEffect>(m_tPixelEffectsParams.aEffect[i])));
+		}
+	}
+
+	if (isMaskSet(PixelEffectsParamsMask::COLOUR)) {
+		printf(" %s=%06X\n", PixelEffectsParamsConst::COLOUR, static_cast<int>(m_tPixelEffectsParams.nColour));
+	}
+
+	if (isMaskSet(PixelEffectsParamsMask::CYCLE_MS)) {
+		printf(" %s=%d\n", PixelEffectsParamsConst::CYCLE_MS, m_tPixelEffectsParams.nCycleMillis);
+	}
+#endif
+}
+
+void PixelEffectsParams::staticCallbackFunction(void *p, const char *s) {
+	assert(p != nullptr);
+	assert(s != nullptr);
+
+	(static_cast<PixelEffectsParams*>(p))->callbackFunction(s);
+}
@@ -0,0 +1,35 @@
+/**
+ * @file pixeleffectsparamsconst.cpp
+ *
+ */
+/* Copyright (C) 2020 by Arjan van Vught mailto:info@orangepi-dmx.nl
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include "pixeleffectsparamsconst.h"
+#include "pixeleffects.h"
+
+const char PixelEffectsParamsConst::FILE_NAME[] = "effects.txt";
+
+const char PixelEffectsParamsConst::EFFECT[] = "effect";
+const char PixelEffectsParamsConst::EFFECT_OUTPUT[PixelEffects::MAX_OUTPUTS][9] = {
+		"effect_1", "effect_2", "effect_3", "effect_4", "effect_5", "effect_6", "effect_7", "effect_8" };
+const char PixelEffectsParamsConst::COLOUR[] = "colour";
+const char PixelEffectsParamsConst::CYCLE_MS[] = "cycle_ms";
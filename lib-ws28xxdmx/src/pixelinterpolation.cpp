@@ -0,0 +1,152 @@
+/**
+ * @file pixelinterpolation.cpp
+ *
+ */
+/* Copyright (C) 2020 by Arjan van Vught mailto:info@orangepi-dmx.nl
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <cassert>
+
+#include "pixelinterpolation.h"
+
+#include "lightset.h"
+
+#include "debug.h"
+
+PixelInterpolation::PixelInterpolation() {
+}
+
+PixelInterpolation::~PixelInterpolation() {
+	delete[] m_pFrames;
+	m_pFrames = nullptr;
+
+	delete[] m_pPorts;
+	m_pPorts = nullptr;
+}
+
+void PixelInterpolation::Setup(uint32_t nPorts) {
+	DEBUG_ENTRY
+
+	delete[] m_pFrames;
+	m_pFrames = nullptr;
+
+	delete[] m_pPorts;
+	m_pPorts = nullptr;
+
+	m_nPorts = 0;
+
+	if ((nPorts == 0) || (m_nOutputHz == 0)) {
+		DEBUG_EXIT
+		return;
+	}
+
+	if (m_nDelayMillis == 0) {
+		m_nDelayMillis = DELAY_MILLIS_DEFAULT;
+	}
+
+	m_nOutputPeriodMicros = 1000000 / m_nOutputHz;
+
+	m_pFrames = new uint8_t[nPorts * 2 * DMX_UNIVERSE_SIZE];
+	assert(m_pFrames != nullptr);
+
+	memset(m_pFrames, 0, nPorts * 2 * DMX_UNIVERSE_SIZE);
+
+	m_pPorts = new struct TPort[nPorts];
+	assert(m_pPorts != nullptr);
+
+	for (uint32_t i = 0; i < nPorts; i++) {
+		m_pPorts[i].nMicros = 0;
+		m_pPorts[i].nLength = 0;
+		m_pPorts[i].nCurrent = 0;
+		m_pPorts[i].bSettled = true;
+	}
+
+	m_nPorts = nPorts;
+
+	DEBUG_PRINTF("m_nPorts=%d, m_nOutputPeriodMicros=%d", static_cast<int>(m_nPorts), static_cast<int>(m_nOutputPeriodMicros));
+	DEBUG_EXIT
+}
+
+void PixelInterpolation::SetData(uint32_t nPort, const uint8_t *pData, uint32_t nLength, uint32_t nMicros) {
+	assert(nLength <= DMX_UNIVERSE_SIZE);
+
+	if (nPort >= m_nPorts) {
+		return;
+	}
+
+	struct TPort &tPort = m_pPorts[nPort];
+
+	// The current frame becomes the previous one
+	tPort.nCurrent ^= 1;
+
+	uint8_t *pCurrent = &m_pFrames[((nPort * 2) + tPort.nCurrent) * DMX_UNIVERSE_SIZE];
+
+	memcpy(pCurrent, pData, nLength);
+
+	if (nLength < tPort.nLength) {
+		memset(&pCurrent[nLength], 0, tPort.nLength - nLength);
+	}
+
+	tPort.nMicros = nMicros;
+	tPort.nLength = static_cast<uint16_t>(nLength);
+	tPort.bSettled = false;
+}
+
+uint32_t PixelInterpolation::Get(uint32_t nPort, uint8_t *pOut, uint32_t nMicros, bool bForce) {
+	if (nPort >= m_nPorts) {
+		return 0;
+	}
+
+	struct TPort &tPort = m_pPorts[nPort];
+
+	if ((tPort.bSettled && !bForce) || (tPort.nLength == 0)) {
+		return 0;
+	}
+
+	const uint8_t *pPrevious = &m_pFrames[((nPort * 2) + (tPort.nCurrent ^ 1)) * DMX_UNIVERSE_SIZE];
+	const uint8_t *pCurrent = &m_pFrames[((nPort * 2) + tPort.nCurrent) * DMX_UNIVERSE_SIZE];
+
+	const uint32_t nElapsed = nMicros - tPort.nMicros;
+	const uint32_t nDelayMicros = m_nDelayMillis * 1000;
+
+	if (nElapsed >= nDelayMicros) {
+		memcpy(pOut, pCurrent, tPort.nLength);
+		tPort.bSettled = true;
+		return tPort.nLength;
+	}
+
+	const uint32_t nWeight = (nElapsed << 8) / nDelayMicros;
+
+	Blend(pPrevious, pCurrent, pOut, tPort.nLength, nWeight);
+
+	return tPort.nLength;
+}
+
+void PixelInterpolation::Print() {
+	if (m_nPorts == 0) {
+		return;
+	}
+
+	printf(" Interpolation : %dHz, %dms\n", static_cast<int>(m_nOutputHz), static_cast<int>(m_nDelayMillis));
+}
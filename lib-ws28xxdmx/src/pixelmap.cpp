@@ -0,0 +1,122 @@
+/**
+ * @file pixelmap.cpp
+ *
+ */
+/* Copyright (C) 2020 by Arjan van Vught mailto:info@orangepi-dmx.nl
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <cassert>
+
+#include "pixelmap.h"
+
+#include "debug.h"
+
+PixelMap::PixelMap() {
+	Clear();
+}
+
+void PixelMap::Clear() {
+	m_nRuns = 0;
+	m_nPortLast = 0;
+
+	memset(m_aPortFirst, 0, sizeof(m_aPortFirst));
+}
+
+bool PixelMap::Add(const struct TPixelMapRun &tRun) {
+	if ((m_nRuns == MAX_RUNS) || (tRun.nCount == 0) || (tRun.nPort >= MAX_PORTS)) {
+		return false;
+	}
+
+	m_aRuns[m_nRuns++] = tRun;
+	return true;
+}
+
+void PixelMap::Compile(uint32_t nOutputs, uint32_t nLedCount, uint32_t nChannelsPerLed) {
+	DEBUG_ENTRY
+	assert((nChannelsPerLed == 3) || (nChannelsPerLed == 4));
+
+	m_nChannelsPerLed = nChannelsPerLed;
+
+	uint32_t aCount[MAX_PORTS];
+	memset(aCount, 0, sizeof(aCount));
+
+	uint32_t nRuns = 0;
+
+	for (uint32_t i = 0; i < m_nRuns; i++) {
+		struct TPixelMapRun tRun = m_aRuns[i];
+
+		const uint32_t nSlot = tRun.nSlot + (tRun.nPixelOffset * nChannelsPerLed);
+		tRun.nSlot = static_cast<uint16_t>(nSlot < DMX_UNIVERSE_SIZE ? nSlot : static_cast<uint32_t>(DMX_UNIVERSE_SIZE));
+		tRun.nPixelOffset = 0;
+
+		const bool bIsValid = (tRun.nOutput < nOutputs)
+				&& (static_cast<uint32_t>(tRun.nLed + tRun.nCount) <= nLedCount)
+				&& ((tRun.nSlot + (tRun.nCount * nChannelsPerLed)) <= DMX_UNIVERSE_SIZE);
+
+		if (!bIsValid) {
+			DEBUG_PRINTF("Dropped run %d", static_cast<int>(i));
+			continue;
+		}
+
+		m_aRuns[nRuns++] = tRun;
+		aCount[tRun.nPort]++;
+	}
+
+	m_nRuns = nRuns;
+
+	// Counting sort on the port, the order within a port is kept
+	m_aPortFirst[0] = 0;
+	m_nPortLast = 0;
+
+	for (uint32_t nPort = 0; nPort < MAX_PORTS; nPort++) {
+		m_aPortFirst[nPort + 1] = m_aPortFirst[nPort] + aCount[nPort];
+
+		if (aCount[nPort] != 0) {
+			m_nPortLast = nPort;
+		}
+	}
+
+	struct TPixelMapRun aRuns[MAX_RUNS];
+	uint32_t aNext[MAX_PORTS];
+
+	memcpy(aNext, m_aPortFirst, sizeof(aNext));
+
+	for (uint32_t i = 0; i < m_nRuns; i++) {
+		aRuns[aNext[m_aRuns[i].nPort]++] = m_aRuns[i];
+	}
+
+	memcpy(m_aRuns, aRuns, m_nRuns * sizeof(struct TPixelMapRun));
+
+	DEBUG_PRINTF("m_nRuns=%d, m_nPortLast=%d", static_cast<int>(m_nRuns), static_cast<int>(m_nPortLast));
+	DEBUG_EXIT
+}
+
+void PixelMap::Dump() {
+	printf("Pixel map\n");
+
+	for (uint32_t i = 0; i < m_nRuns; i++) {
+		const struct TPixelMapRun &tRun = m_aRuns[i];
+		printf(" %d:%d -> %d:%d [%d]%s\n", tRun.nPort, tRun.nSlot + 1, tRun.nOutput, tRun.nLed, tRun.nCount, tRun.bReverse ? " reverse" : "");
+	}
+}
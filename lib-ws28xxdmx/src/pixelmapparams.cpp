@@ -0,0 +1,220 @@
+/**
+ * @file pixelmapparams.cpp
+ *
+ */
+/* Copyright (C) 2020 by Arjan van Vught mailto:info@orangepi-dmx.nl
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#if !defined(__clang__)	// Needed for compiling on MacOS
+# pragma GCC push_options
+# pragma GCC optimize ("Os")
+#endif
+
+#include <stdint.h>
+#include <stdio.h>
+#include <cassert>
+
+#include "pixelmapparams.h"
+#include "pixelmapparamsconst.h"
+#include "pixelmap.h"
+
+#include "readconfigfile.h"
+#include "sscan.h"
+
+#include "debug.h"
+
+namespace pixelmapparams {
+static constexpr uint32_t MAX_VALUES = 6;
+
+/**
+ * Parses "n,n,n[,n][,r]" -> returns the number of values, bReverse is set with a trailing 'r'
+ */
+static uint32_t parse(const char *pValue, uint32_t nLength, uint32_t *pValues, bool& bReverse) {
+	uint32_t nValues = 0;
+	uint32_t nValue = 0;
+	bool bDigits = false;
+
+	bReverse = false;
+
+	for (uint32_t i = 0; i < nLength; i++) {
+		const char c = pValue[i];
+
+		if ((c >= '0') && (c <= '9')) {
+			nValue = (nValue * 10) + static_cast<uint32_t>(c - '0');
+			bDigits = true;
+			if (nValue > UINT16_MAX) {
+				return 0;
+			}
+		} else if (c == ',') {
+			if (!bDigits || (nValues == MAX_VALUES)) {
+				return 0;
+			}
+			pValues[nValues++] = nValue;
+			nValue = 0;
+			bDigits = false;
+		} else if ((c == 'r') || (c == 'R')) {
+			if (bDigits) {
+				return 0;
+			}
+			bReverse = true;
+		} else if ((c != ' ') && (c != '\t') && (c != '\r')) {
+			return 0;
+		}
+	}
+
+	if (bDigits) {
+		if (nValues == MAX_VALUES) {
+			return 0;
+		}
+		pValues[nValues++] = nValue;
+	} else if (!bReverse) {
+		return 0;
+	}
+
+	return nValues;
+}
+}  // namespace pixelmapparams
+
+using namespace pixelmapparams;
+
+PixelMapParams::PixelMapParams() {
+}
+
+bool PixelMapParams::Load() {
+	m_nRuns = 0;
+
+	ReadConfigFile configfile(PixelMapParams::staticCallbackFunction, this);
+
+	return configfile.Read(PixelMapParamsConst::FILE_NAME) && (m_nRuns != 0);
+}
+
+void PixelMapParams::Load(const char *pBuffer, uint32_t nLength) {
+	assert(pBuffer != nullptr);
+	assert(nLength != 0);
+
+	m_nRuns = 0;
+
+	ReadConfigFile config(PixelMapParams::staticCallbackFunction, this);
+
+	config.Read(pBuffer, nLength);
+}
+
+void PixelMapParams::Add(const struct TPixelMapRun &tRun) {
+	if ((m_nRuns == PixelMap::MAX_RUNS) || (tRun.nCount == 0) || (tRun.nSlot >= DMX_UNIVERSE_SIZE) || (tRun.nPort >= PixelMap::MAX_PORTS)) {
+		DEBUG_PRINTF("Skipped: port=%u, slot=%u, count=%u", tRun.nPort, tRun.nSlot, tRun.nCount);
+		return;
+	}
+
+	m_aRuns[m_nRuns++] = tRun;
+}
+
+void PixelMapParams::callbackFunction(const char *pLine) {
+	assert(pLine != nullptr);
+
+	char cBuffer[48];
+	uint32_t aValues[MAX_VALUES];
+	bool bReverse;
+
+	uint32_t nLength = sizeof(cBuffer) - 1;
+
+	if (Sscan::Char(pLine, PixelMapParamsConst::RUN, cBuffer, nLength) == Sscan::OK) {
+		// run=<port>,<slot>,<output>,<led>,<count>[,r]
+		if (parse(cBuffer, nLength, aValues, bReverse) != 5) {
+			return;
+		}
+
+		if (aValues[1] == 0) {
+			return;
+		}
+
+		struct TPixelMapRun tRun;
+
+		tRun.nPort = static_cast<uint8_t>(aValues[0] < UINT8_MAX ? aValues[0] : UINT8_MAX);
+		tRun.nSlot = static_cast<uint16_t>(aValues[1] - 1);
+		tRun.nPixelOffset = 0;
+		tRun.nOutput = static_cast<uint8_t>(aValues[2] < UINT8_MAX ? aValues[2] : UINT8_MAX);
+		tRun.nLed = static_cast<uint16_t>(aValues[3]);
+		tRun.nCount = static_cast<uint16_t>(aValues[4]);
+		tRun.bReverse = bReverse;
+
+		Add(tRun);
+		return;
+	}
+
+	nLength = sizeof(cBuffer) - 1;
+
+	if (Sscan::Char(pLine, PixelMapParamsConst::ZIGZAG, cBuffer, nLength) == Sscan::OK) {
+		// zigzag=<port>,<slot>,<output>,<led>,<width>,<rows>
+		if ((parse(cBuffer, nLength, aValues, bReverse) != 6) || bReverse) {
+			return;
+		}
+
+		if ((aValues[1] == 0) || (aValues[4] == 0)) {
+			return;
+		}
+
+		struct TPixelMapRun tRun;
+
+		tRun.nPort = static_cast<uint8_t>(aValues[0] < UINT8_MAX ? aValues[0] : UINT8_MAX);
+		tRun.nOutput = static_cast<uint8_t>(aValues[2] < UINT8_MAX ? aValues[2] : UINT8_MAX);
+		tRun.nCount = static_cast<uint16_t>(aValues[4]);
+
+		const uint32_t nRows = aValues[5];
+
+		for (uint32_t nRow = 0; nRow < nRows; nRow++) {
+			const uint32_t nOffset = nRow * aValues[4];
+			tRun.nSlot = static_cast<uint16_t>(aValues[1] - 1);
+			tRun.nPixelOffset = static_cast<uint16_t>(nOffset);
+			tRun.nLed = static_cast<uint16_t>(aValues[3] + nOffset);
+			tRun.bReverse = ((nRow & 0x1) == 0x1);
+			Add(tRun);
+		}
+		return;
+	}
+}
+
+void PixelMapParams::Set(PixelMap *pPixelMap) {
+	assert(pPixelMap != nullptr);
+
+	pPixelMap->Clear();
+
+	for (uint32_t i = 0; i < m_nRuns; i++) {
+		pPixelMap->Add(m_aRuns[i]);
+	}
+}
+
+void PixelMapParams::Dump() {
+#ifndef NDEBUG
+	printf("%s::%s \'%s\':\n", __FILE__, __FUNCTION__, PixelMapParamsConst::FILE_NAME);
+
+	for (uint32_t i = 0; i < m_nRuns; i++) {
+		const struct TPixelMapRun &tRun = m_aRuns[i];
+		printf(" %s=%u,%u(+%u),%u,%u,%u%s\n", PixelMapParamsConst::RUN, tRun.nPort, tRun.nSlot + 1U, tRun.nPixelOffset, tRun.nOutput, tRun.nLed, tRun.nCount, tRun.bReverse ? ",r" : "");
+	}
+#endif
+}
+
+void PixelMapParams::staticCallbackFunction(void *p, const char *s) {
+	assert(p != nullptr);
+	assert(s != nullptr);
+
+	(static_cast<PixelMapParams*>(p))->callbackFunction(s);
+}
@@ -27,6 +27,10 @@
 #include <algorithm>
 #include <cassert>
 
+#ifndef ALIGNED
+ #define ALIGNED __attribute__ ((aligned (4)))
+#endif
+
 #ifndef NDEBUG
 #if (__linux__)
  #include <stdio.h>
@@ -39,6 +43,8 @@
 #include "lightset.h"
 #include "lightsetdisplay.h"
 
+#include "hardware.h"
+
 WS28xxDmx::WS28xxDmx() :
 	m_tLedType(WS2812B),
 	m_tRGBMapping(RGB_MAPPING_UNDEFINED),
@@ -53,9 +59,7 @@ WS28xxDmx::WS28xxDmx() :
 	m_pWS28xxDmxStore(nullptr),
 	m_nClockSpeedHz(0),
 	m_nGlobalBrightness(0xFF),
-	m_nBeginIndexPortId1(170),
-	m_nBeginIndexPortId2(340),
-	m_nBeginIndexPortId3(510),
+	m_nLedsPerUniverse(LEDCOUNT_RGB_UNIVERSE),
 	m_nChannelsPerLed(3),
 	m_nPortIdLast(3)
 {
@@ -73,12 +77,21 @@ void WS28xxDmx::Start(__attribute__((unused)) uint8_t nPort) {
 	}
 
 	m_bIsStarted = true;
+	m_bFailsafe = false;
 
 	if (m_pLEDStripe == nullptr) {
 		m_pLEDStripe = new WS28xx(m_tLedType, m_nLedCount, m_tRGBMapping, m_nLowCode, m_nHighCode, m_nClockSpeedHz);
 		assert(m_pLEDStripe != nullptr);
 		m_pLEDStripe->SetGlobalBrightness(m_nGlobalBrightness);
 		m_pLEDStripe->Initialize();
+
+		m_Correction.Generate();
+
+		if (m_Correction.IsDither()) {
+			m_Correction.SetupRetain(m_nPortIdLast + 1);
+		}
+
+		m_Interpolation.Setup(m_nPortIdLast + 1);
 	} else {
 		while (m_pLEDStripe->IsUpdating()) {
 			// wait for completion
@@ -95,6 +108,13 @@ void WS28xxDmx::Stop(__attribute__((unused)) uint8_t nPort) {
 	m_bIsStarted = false;
 
 	if (m_pLEDStripe != nullptr) {
+		if ((m_pPixelEffects != nullptr) && m_pPixelEffects->IsEnabled()) {
+			// The failsafe scene takes over in FrameRun
+			m_bFailsafe = true;
+			m_nFailsafeMillis = Hardware::Get()->Millis() - FAILSAFE_FRAME_MILLIS;
+			return;
+		}
+
 		while (m_pLEDStripe->IsUpdating()) {
 			// wait for completion
 		}
@@ -103,40 +123,62 @@ void WS28xxDmx::Stop(__attribute__((unused)) uint8_t nPort) {
 }
 
 void WS28xxDmx::SetData(uint8_t nPortId, const uint8_t *pData, uint16_t nLength) {
+	struct TLightSetDirty tDirty;
+	lightset::data::SetAll(tDirty, nLength);
+
+	SetDataRange(nPortId, pData, nLength, tDirty);
+}
+
+void WS28xxDmx::SetDataRange(uint8_t nPortId, const uint8_t *pData, uint16_t nLength, const struct TLightSetDirty &tDirty) {
 	assert(pData != nullptr);
 	assert(nLength <= DMX_UNIVERSE_SIZE);
 
-	uint32_t i = 0;
-	uint32_t beginIndex, endIndex;
-
 	if (__builtin_expect((m_pLEDStripe == nullptr), 0)) {
 		m_bIsStarted = false;
 		Start();
 	}
 
-	switch (nPortId & 0x03) {
-	case 0:
-		beginIndex = 0;
-		endIndex = std::min(m_nLedCount, static_cast<uint16_t>(nLength / m_nChannelsPerLed));
-		if (m_nLedCount < m_nBeginIndexPortId1) {
-			i = static_cast<uint32_t>(m_nDmxStartAddress - 1);
-		}
-		break;
-	case 1:
-		beginIndex = m_nBeginIndexPortId1;
-		endIndex = std::min(m_nLedCount, static_cast<uint16_t>(beginIndex + (nLength /  m_nChannelsPerLed)));
-		break;
-	case 2:
-		beginIndex = m_nBeginIndexPortId2;
-		endIndex = std::min(m_nLedCount, static_cast<uint16_t>(beginIndex + (nLength /  m_nChannelsPerLed)));
-		break;
-	case 3:
-		beginIndex = m_nBeginIndexPortId3;
-		endIndex = std::min(m_nLedCount, static_cast<uint16_t>(beginIndex + (nLength /  m_nChannelsPerLed)));
-		break;
-	default:
-		__builtin_unreachable();
-		break;
+	if (m_Interpolation.IsEnabled()) {
+		// The output is driven by FrameRun
+		m_Interpolation.SetData(nPortId, pData, nLength, Hardware::Get()->Micros());
+		return;
+	}
+
+	if (m_Correction.IsDither()) {
+		m_Correction.Retain(nPortId, pData, nLength);
+	}
+
+	Encode(nPortId, pData, nLength, tDirty);
+
+	if (!m_bFrameCommit && (nPortId == m_nPortIdLast)) {
+		m_pLEDStripe->Update();
+	}
+}
+
+void WS28xxDmx::Encode(uint8_t nPortId, const uint8_t *pData, uint16_t nLength, const struct TLightSetDirty &tDirty) {
+	uint32_t i = 0;
+
+	// Each port (universe) drives the next m_nLedsPerUniverse LEDs
+	uint32_t beginIndex = nPortId * m_nLedsPerUniverse;
+	uint32_t endIndex = std::min(static_cast<uint32_t>(m_nLedCount), beginIndex + (nLength / m_nChannelsPerLed));
+
+	if ((nPortId == 0) && (m_nLedCount < m_nLedsPerUniverse)) {
+		i = static_cast<uint32_t>(m_nDmxStartAddress - 1);
+	}
+
+	/*
+	 * Only the LEDs covering the changed slots are re-encoded,
+	 * the LED buffer still holds the others.
+	 */
+	if (lightset::data::IsClean(tDirty) || (tDirty.nLast < i)) {
+		endIndex = beginIndex;
+	} else {
+		const uint32_t nLedFirst = tDirty.nFirst > i ? (tDirty.nFirst - i) / m_nChannelsPerLed : 0;
+		const uint32_t nLedLast = (tDirty.nLast - i) / m_nChannelsPerLed;
+
+		endIndex = std::min(endIndex, beginIndex + nLedLast + 1);
+		beginIndex += nLedFirst;
+		i += nLedFirst * m_nChannelsPerLed;
 	}
 
 #ifndef NDEBUG
@@ -149,37 +191,158 @@ void WS28xxDmx::SetData(uint8_t nPortId, const uint8_t *pData, uint16_t nLength)
 		// wait for completion
 	}
 
-	for (uint32_t j = beginIndex; j < endIndex; j++) {
-		__builtin_prefetch(&pData[i]);
-		if (m_tLedType == SK6812W) {
-			if (i + 3 > nLength) {
-				break;
-			}
-			m_pLEDStripe->SetLED(j, pData[i], pData[i + 1], pData[i + 2], pData[i + 3]);
-			i = i + 4;
-		} else {
-			if (i + 2 > nLength) {
-				break;
-			}
-			m_pLEDStripe->SetLED(j, pData[i], pData[i + 1], pData[i + 2]);
-			i = i + 3;
+	if (endIndex > beginIndex) {
+		const uint32_t nPixels = (i < nLength) ? (nLength - i) / m_nChannelsPerLed : 0;
+		SetLEDs(beginIndex, &pData[i], std::min(endIndex - beginIndex, nPixels));
+	}
+}
+
+void WS28xxDmx::SetLEDs(uint32_t nFirstLed, const uint8_t *pData, uint32_t nCount) {
+	if (!m_Correction.IsEnabled()) {
+		m_pLEDStripe->SetLEDs(nFirstLed, pData, nCount);
+		return;
+	}
+
+	uint8_t aCorrected[DMX_UNIVERSE_SIZE];
+	const uint32_t nChunk = DMX_UNIVERSE_SIZE / m_nChannelsPerLed;
+
+	while (nCount != 0) {
+		const uint32_t n = std::min(nCount, nChunk);
+
+		m_Correction.Apply(pData, aCorrected, nFirstLed, n, m_nChannelsPerLed);
+		m_pLEDStripe->SetLEDs(nFirstLed, aCorrected, n);
+
+		pData += n * m_nChannelsPerLed;
+		nFirstLed += n;
+		nCount -= n;
+	}
+}
+
+void WS28xxDmx::FrameBegin() {
+	m_bFrameCommit = true;
+}
+
+void WS28xxDmx::FrameCommit() {
+	if (__builtin_expect((m_pLEDStripe == nullptr), 0) || m_Interpolation.IsEnabled()) {
+		return;
+	}
+
+	while (m_pLEDStripe->IsUpdating()) {
+		// wait for completion
+	}
+
+	m_pLEDStripe->Update();
+}
+
+void WS28xxDmx::FrameRun() {
+	if (m_bFailsafe) {
+		RunFailsafe();
+		return;
+	}
+
+	if (m_Interpolation.IsEnabled()) {
+		RunInterpolation();
+		return;
+	}
+
+	if (!m_Correction.IsDither() || !m_bIsStarted || m_bBlackout || (m_pLEDStripe == nullptr) || m_pLEDStripe->IsUpdating()) {
+		return;
+	}
+
+	// The output is faster than the input, the retained input is sent again with the next dither thresholds
+	m_Correction.NextFrame();
+
+	struct TLightSetDirty tDirty;
+
+	for (uint32_t nPortId = 0; nPortId <= m_nPortIdLast; nPortId++) {
+		uint32_t nLength;
+		const uint8_t *pData = m_Correction.GetRetained(nPortId, nLength);
+
+		if (nLength != 0) {
+			lightset::data::SetAll(tDirty, nLength);
+			Encode(static_cast<uint8_t>(nPortId), pData, static_cast<uint16_t>(nLength), tDirty);
 		}
 	}
 
-	if (nPortId == m_nPortIdLast) {
+	m_pLEDStripe->Update();
+}
+
+void WS28xxDmx::RunInterpolation() {
+	if (!m_bIsStarted || m_bBlackout || (m_pLEDStripe == nullptr) || m_pLEDStripe->IsUpdating()) {
+		return;
+	}
+
+	const uint32_t nMicros = Hardware::Get()->Micros();
+
+	if (!m_Interpolation.IsOutputDue(nMicros)) {
+		return;
+	}
+
+	// With dithering the settled ports are sent again as well
+	const bool bDither = m_Correction.IsDither();
+
+	if (bDither) {
+		m_Correction.NextFrame();
+	}
+
+	uint8_t aFrame[DMX_UNIVERSE_SIZE] ALIGNED;
+	struct TLightSetDirty tDirty;
+	bool bIsUpdated = false;
+
+	for (uint32_t nPortId = 0; nPortId <= m_nPortIdLast; nPortId++) {
+		const uint32_t nLength = m_Interpolation.Get(nPortId, aFrame, nMicros, bDither);
+
+		if (nLength != 0) {
+			lightset::data::SetAll(tDirty, nLength);
+			Encode(static_cast<uint8_t>(nPortId), aFrame, static_cast<uint16_t>(nLength), tDirty);
+			bIsUpdated = true;
+		}
+	}
+
+	if (bIsUpdated) {
 		m_pLEDStripe->Update();
 	}
 }
 
+void WS28xxDmx::RunFailsafe() {
+	if (!m_bFailsafe || m_bBlackout || m_pLEDStripe->IsUpdating()) {
+		return;
+	}
+
+	const uint32_t nMillis = Hardware::Get()->Millis();
+
+	if ((nMillis - m_nFailsafeMillis) < FAILSAFE_FRAME_MILLIS) {
+		return;
+	}
+
+	m_nFailsafeMillis = nMillis;
+
+	if (m_Correction.IsDither()) {
+		m_Correction.NextFrame();
+	}
+
+	uint8_t aPixels[DMX_UNIVERSE_SIZE] ALIGNED;
+	const uint32_t nChunk = DMX_UNIVERSE_SIZE / m_nChannelsPerLed;
+
+	for (uint32_t nFirst = 0; nFirst < m_nLedCount; nFirst += nChunk) {
+		const uint32_t nCount = std::min(m_nLedCount - nFirst, nChunk);
+
+		m_pPixelEffects->Render(0, aPixels, nFirst, nCount, m_nLedCount, m_nChannelsPerLed, nMillis);
+		SetLEDs(nFirst, aPixels, nCount);
+	}
+
+	m_pLEDStripe->Update();
+}
+
 void WS28xxDmx::SetLEDType(TWS28XXType type) {
 	m_tLedType = type;
 
 	if (type == SK6812W) {
-		m_nBeginIndexPortId1 = 128;
-		m_nBeginIndexPortId2 = 256;
-		m_nBeginIndexPortId3 = 384;
-
+		m_nLedsPerUniverse = LEDCOUNT_RGBW_UNIVERSE;
 		m_nChannelsPerLed = 4;
+	} else {
+		m_nLedsPerUniverse = LEDCOUNT_RGB_UNIVERSE;
+		m_nChannelsPerLed = 3;
 	}
 
 	UpdateMembers();
@@ -198,7 +361,7 @@ void WS28xxDmx::UpdateMembers() {
 		m_nDmxFootprint = DMX_UNIVERSE_SIZE;
 	}
 
-	m_nPortIdLast = m_nLedCount / (1 + m_nBeginIndexPortId1);
+	m_nPortIdLast = (m_nLedCount == 0) ? 0 : (m_nLedCount - 1U) / m_nLedsPerUniverse;
 }
 
 void WS28xxDmx::Blackout(bool bBlackout) {
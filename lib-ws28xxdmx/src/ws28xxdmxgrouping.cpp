@@ -75,27 +75,12 @@ void WS28xxDmxGrouping::SetData(__attribute__((unused)) uint8_t nPort, const uin
 	}
 
 	if (bIsChanged) {
-		uint32_t i = 0;
-		uint32_t d = 0;
-
-		if (m_tLedType == SK6812W) {
-			for (uint32_t g = 0; g < m_nGroups; g++) {
-				__builtin_prefetch(&m_pDmxData[d]);
-				for (uint32_t k = 0; k < m_nLEDGroupCount; k++) {
-					m_pLEDStripe->SetLED(k + i, m_pDmxData[d + 0], m_pDmxData[d + 1], m_pDmxData[d + 2], m_pDmxData[d + 3]);
-				}
-				i = i + m_nLEDGroupCount;
-				d = d + 4;
-			}
+		if (m_Correction.IsEnabled()) {
+			uint8_t aCorrected[DMX_UNIVERSE_SIZE];
+			m_Correction.Apply(m_pDmxData, aCorrected, 0, m_nGroups, m_tLedType == SK6812W ? 4 : 3);
+			m_pLEDStripe->SetLEDs(0, aCorrected, m_nGroups, m_nLEDGroupCount);
 		} else {
-			for (uint32_t g = 0; g < m_nGroups; g++) {
-				__builtin_prefetch(&m_pDmxData[d]);
-				for (uint32_t k = 0; k < m_nLEDGroupCount; k++) {
-					m_pLEDStripe->SetLED(k + i, m_pDmxData[d + 0], m_pDmxData[d + 1], m_pDmxData[d + 2]);
-				}
-				i = i + m_nLEDGroupCount;
-				d = d + 3;
-			}
+			m_pLEDStripe->SetLEDs(0, m_pDmxData, m_nGroups, m_nLEDGroupCount);
 		}
 
 		if (!m_bBlackout) {
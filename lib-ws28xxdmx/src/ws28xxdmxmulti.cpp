@@ -28,6 +28,10 @@
 #include <algorithm>
 #include <cassert>
 
+#ifndef ALIGNED
+ #define ALIGNED __attribute__ ((aligned (4)))
+#endif
+
 #include "ws28xxdmxmulti.h"
 #include "ws28xxmulti.h"
 #include "ws28xxdmxparams.h"
@@ -35,6 +39,8 @@
 
 #include "rgbmapping.h"
 
+#include "hardware.h"
+
 #include "debug.h"
 
 WS28xxDmxMulti::WS28xxDmxMulti(TWS28xxDmxMultiSrc tSrc):
@@ -49,9 +55,8 @@ WS28xxDmxMulti::WS28xxDmxMulti(TWS28xxDmxMultiSrc tSrc):
 	m_bIsStarted(false),
 	m_bBlackout(false),
 	m_nUniverses(1), // -> m_nLedCount(170)
-	m_nBeginIndexPortId1(170),
-	m_nBeginIndexPortId2(340),
-	m_nBeginIndexPortId3(510),
+	m_nPortsPerOutput(1),
+	m_nLedsPerUniverse(LEDCOUNT_RGB_UNIVERSE),
 	m_nChannelsPerLed(3),
 	m_nPortIdLast(3), // -> (m_nActiveOutputs * m_nUniverses) -1;
 	m_bUseSI5351A(false)
@@ -75,6 +80,18 @@ void WS28xxDmxMulti::Initialize() {
 
 	m_pLEDStripe->Initialize(m_tLedType, m_nLedCount, m_tRGBMapping, m_nLowCode, m_nHighCode, m_bUseSI5351A);
 
+	// The LED count can be reduced by the board
+	m_nLedCount = m_pLEDStripe->GetLEDCount();
+	UpdateMembers();
+
+	m_Correction.Generate();
+
+	if (m_Correction.IsDither()) {
+		m_Correction.SetupRetain(m_nPortIdLast + 1);
+	}
+
+	m_Interpolation.Setup(m_nPortIdLast + 1);
+
 	while (m_pLEDStripe->IsUpdating()) {
 		// wait for completion
 	}
@@ -92,10 +109,7 @@ void WS28xxDmxMulti::Start(__attribute__((unused)) uint8_t nPort) {
 	}
 
 	m_bIsStarted = true;
-
-	while (m_pLEDStripe->IsUpdating()) {
-		// wait for completion
-	}
+	m_bFailsafe = false;
 
 	m_pLEDStripe->Update();
 }
@@ -111,6 +125,13 @@ void WS28xxDmxMulti::Stop(__attribute__((unused)) uint8_t nPort) {
 
 	m_bIsStarted = false;
 
+	if ((m_pPixelEffects != nullptr) && m_pPixelEffects->IsEnabled()) {
+		// The failsafe scene takes over in FrameRun
+		m_bFailsafe = true;
+		m_nFailsafeMillis = Hardware::Get()->Millis() - FAILSAFE_FRAME_MILLIS;
+		return;
+	}
+
 	while (m_pLEDStripe->IsUpdating()) {
 		// wait for completion
 	}
@@ -119,81 +140,265 @@ void WS28xxDmxMulti::Stop(__attribute__((unused)) uint8_t nPort) {
 }
 
 void WS28xxDmxMulti::SetData(uint8_t nPortId, const uint8_t* pData, uint16_t nLength) {
+	struct TLightSetDirty tDirty;
+	lightset::data::SetAll(tDirty, nLength);
+
+	SetDataRange(nPortId, pData, nLength, tDirty);
+}
+
+void WS28xxDmxMulti::SetDataRange(uint8_t nPortId, const uint8_t* pData, uint16_t nLength, const struct TLightSetDirty &tDirty) {
 	assert(pData != nullptr);
 	assert(nLength <= DMX_UNIVERSE_SIZE);
 	assert(m_pLEDStripe != nullptr);
 
+	if (m_Interpolation.IsEnabled()) {
+		// The output is driven by FrameRun
+		m_Interpolation.SetData(nPortId, pData, nLength, Hardware::Get()->Micros());
+		return;
+	}
+
+	if (m_Correction.IsDither()) {
+		m_Correction.Retain(nPortId, pData, nLength);
+	}
+
+	Encode(nPortId, pData, nLength, tDirty);
+
+	if (!m_bFrameCommit && (nPortId == m_nPortIdLast)) {
+		m_pLEDStripe->Update();
+	}
+}
+
+void WS28xxDmxMulti::Encode(uint8_t nPortId, const uint8_t* pData, uint16_t nLength, const struct TLightSetDirty &tDirty) {
+	if (m_pPixelMap != nullptr) {
+		m_pPixelMap->Run(*this, nPortId, pData, nLength, tDirty);
+		return;
+	}
+
+	if (m_nLedGroupCount > 1) {
+		// The first port of an output holds the groups
+		const uint32_t nOutIndex = nPortId / m_nPortsPerOutput;
+
+		if ((nPortId != (nOutIndex * m_nPortsPerOutput)) || lightset::data::IsClean(tDirty)) {
+			return;
+		}
+
+		const uint32_t nFirst = tDirty.nFirst / m_nChannelsPerLed;
+		const uint32_t nEnd = std::min(m_nGroups, std::min((tDirty.nLast / m_nChannelsPerLed) + 1, nLength / m_nChannelsPerLed));
+
+		if (nEnd > nFirst) {
+			SetLEDs(static_cast<uint8_t>(nOutIndex), nFirst * m_nLedGroupCount, &pData[nFirst * m_nChannelsPerLed], nEnd - nFirst, m_nLedGroupCount);
+		}
+		return;
+	}
+
 	uint32_t i = 0;
-	uint32_t beginIndex, endIndex;
-
-	switch (nPortId & ~static_cast<uint8_t>(m_nUniverses) & 0x03) {
-	case 0:
-		beginIndex = 0;
-		endIndex = std::min(m_nLedCount, (nLength / m_nChannelsPerLed));
-		break;
-	case 1:
-		beginIndex = m_nBeginIndexPortId1;
-		endIndex = std::min(m_nLedCount, (beginIndex + (nLength / m_nChannelsPerLed)));
-		break;
-	case 2:
-		beginIndex = m_nBeginIndexPortId2;
-		endIndex = std::min(m_nLedCount, (beginIndex + (nLength / m_nChannelsPerLed)));
-		break;
-	case 3:
-		beginIndex = m_nBeginIndexPortId3;
-		endIndex = std::min(m_nLedCount, (beginIndex + (nLength / m_nChannelsPerLed)));
-		break;
-	default:
-		__builtin_unreachable();
-		break;
-	}
-
-	uint32_t nOutIndex;
 
-	if (m_tSrc == WS28XXDMXMULTI_SRC_E131) {
-		nOutIndex = nPortId / m_nUniverses;
+	const uint32_t nOutIndex = nPortId / m_nPortsPerOutput;
+	const uint32_t nUniverse = nPortId - (nOutIndex * m_nPortsPerOutput);
+
+	// Each universe of an output drives the next m_nLedsPerUniverse LEDs
+	uint32_t beginIndex = nUniverse * m_nLedsPerUniverse;
+	uint32_t endIndex = std::min(m_nLedCount, beginIndex + (nLength / m_nChannelsPerLed));
+
+	/*
+	 * Only the LEDs covering the changed slots are re-encoded,
+	 * the LED buffer still holds the others.
+	 */
+	if (lightset::data::IsClean(tDirty)) {
+		endIndex = beginIndex;
 	} else {
-		nOutIndex = nPortId / 4;
+		const uint32_t nLedFirst = tDirty.nFirst / m_nChannelsPerLed;
+		const uint32_t nLedLast = tDirty.nLast / m_nChannelsPerLed;
+
+		endIndex = std::min(endIndex, beginIndex + nLedLast + 1);
+		beginIndex += nLedFirst;
+		i = nLedFirst * m_nChannelsPerLed;
 	}
 
 	DEBUG_PRINTF("nPort=%d, nLength=%d, nOutIndex=%d, nPortId=%d, beginIndex=%d, endIndex=%d",
 			static_cast<int>(nPortId), static_cast<int>(nLength), static_cast<int>(nOutIndex),
-			static_cast<int>(nPortId & ~m_nUniverses & 0x03), static_cast<int>(beginIndex), static_cast<int>(endIndex));
+			static_cast<int>(nUniverse), static_cast<int>(beginIndex), static_cast<int>(endIndex));
 
-	while (m_pLEDStripe->IsUpdating()) {
-		// wait for completion
+	// The LEDs are encoded into the back buffer, there is no need to wait for the DMA
+
+	if (endIndex > beginIndex) {
+		const uint32_t nPixels = (i < nLength) ? (nLength - i) / m_nChannelsPerLed : 0;
+		SetLEDs(static_cast<uint8_t>(nOutIndex), beginIndex, &pData[i], std::min(endIndex - beginIndex, nPixels));
+	}
+}
+
+void WS28xxDmxMulti::SetLEDs(uint8_t nOutput, uint32_t nFirstLed, const uint8_t *pData, uint32_t nCount, uint32_t nGroupCount) {
+	if (!m_Correction.IsEnabled()) {
+		m_pLEDStripe->SetLEDs(nOutput, nFirstLed, pData, nCount, nGroupCount);
+		return;
+	}
+
+	uint8_t aCorrected[DMX_UNIVERSE_SIZE];
+	const uint32_t nChunk = DMX_UNIVERSE_SIZE / m_nChannelsPerLed;
+
+	while (nCount != 0) {
+		const uint32_t n = std::min(nCount, nChunk);
+
+		m_Correction.Apply(pData, aCorrected, nFirstLed, n, m_nChannelsPerLed);
+		m_pLEDStripe->SetLEDs(nOutput, nFirstLed, aCorrected, n, nGroupCount);
+
+		pData += n * m_nChannelsPerLed;
+		nFirstLed += n * nGroupCount;
+		nCount -= n;
 	}
+}
+
+void WS28xxDmxMulti::SetPixelMap(PixelMap *pPixelMap) {
+	DEBUG_ENTRY
+	assert(m_pLEDStripe != nullptr);
+
+	m_pPixelMap = pPixelMap;
+
+	if (m_pPixelMap != nullptr) {
+		m_pPixelMap->Compile(m_nActiveOutputs, m_nLedCount, m_nChannelsPerLed);
+	}
+
+	UpdateMembers();
+
+	if (m_Correction.IsDither()) {
+		m_Correction.SetupRetain(m_nPortIdLast + 1);
+	}
+
+	m_Interpolation.Setup(m_nPortIdLast + 1);
+
+	DEBUG_EXIT
+}
+
+void WS28xxDmxMulti::FrameBegin() {
+	m_bFrameCommit = true;
+}
+
+void WS28xxDmxMulti::FrameCommit() {
+	if (__builtin_expect((m_pLEDStripe == nullptr), 0) || m_Interpolation.IsEnabled()) {
+		return;
+	}
+
+	m_pLEDStripe->Update();
+}
 
-	for (uint32_t j = beginIndex; j < endIndex; j++) {
-		__builtin_prefetch(&pData[i]);
-		if (m_tLedType == SK6812W) {
-			if (i + 3 > nLength) {
-				break;
-			}
-			m_pLEDStripe->SetLED(nOutIndex, j, pData[i], pData[i + 1], pData[i + 2], pData[i + 3]);
-			i = i + 4;
-		} else {
-			if (i + 2 > nLength) {
-				break;
-			}
-			m_pLEDStripe->SetLED(nOutIndex, j, pData[i], pData[i + 1], pData[i + 2]);
-			i = i + 3;
+void WS28xxDmxMulti::FrameRun() {
+	if (__builtin_expect((m_pLEDStripe == nullptr), 0)) {
+		return;
+	}
+
+	m_pLEDStripe->Run();
+
+	if (m_bFailsafe) {
+		RunFailsafe();
+		return;
+	}
+
+	if (m_Interpolation.IsEnabled()) {
+		RunInterpolation();
+		return;
+	}
+
+	if (!m_Correction.IsDither() || !m_bIsStarted || m_bBlackout || m_pLEDStripe->IsPending() || m_pLEDStripe->IsUpdating()) {
+		return;
+	}
+
+	// The output is faster than the input, the retained input is sent again with the next dither thresholds
+	m_Correction.NextFrame();
+
+	struct TLightSetDirty tDirty;
+
+	for (uint32_t nPortId = 0; nPortId <= m_nPortIdLast; nPortId++) {
+		uint32_t nLength;
+		const uint8_t *pData = m_Correction.GetRetained(nPortId, nLength);
+
+		if (nLength != 0) {
+			lightset::data::SetAll(tDirty, nLength);
+			Encode(static_cast<uint8_t>(nPortId), pData, static_cast<uint16_t>(nLength), tDirty);
 		}
 	}
 
-	if (nPortId == m_nPortIdLast) {
+	m_pLEDStripe->Update();
+}
+
+void WS28xxDmxMulti::RunInterpolation() {
+	if (!m_bIsStarted || m_bBlackout || m_pLEDStripe->IsPending() || m_pLEDStripe->IsUpdating()) {
+		return;
+	}
+
+	const uint32_t nMicros = Hardware::Get()->Micros();
+
+	if (!m_Interpolation.IsOutputDue(nMicros)) {
+		return;
+	}
+
+	// With dithering the settled ports are sent again as well
+	const bool bDither = m_Correction.IsDither();
+
+	if (bDither) {
+		m_Correction.NextFrame();
+	}
+
+	uint8_t aFrame[DMX_UNIVERSE_SIZE] ALIGNED;
+	struct TLightSetDirty tDirty;
+	bool bIsUpdated = false;
+
+	for (uint32_t nPortId = 0; nPortId <= m_nPortIdLast; nPortId++) {
+		const uint32_t nLength = m_Interpolation.Get(nPortId, aFrame, nMicros, bDither);
+
+		if (nLength != 0) {
+			lightset::data::SetAll(tDirty, nLength);
+			Encode(static_cast<uint8_t>(nPortId), aFrame, static_cast<uint16_t>(nLength), tDirty);
+			bIsUpdated = true;
+		}
+	}
+
+	if (bIsUpdated) {
 		m_pLEDStripe->Update();
 	}
 }
 
-void WS28xxDmxMulti::Blackout(bool bBlackout) {
-	m_bBlackout = bBlackout;
+void WS28xxDmxMulti::RunFailsafe() {
+	if (m_bBlackout || m_pLEDStripe->IsPending() || m_pLEDStripe->IsUpdating()) {
+		return;
+	}
 
-	while (m_pLEDStripe->IsUpdating()) {
-		// wait for completion
+	const uint32_t nMillis = Hardware::Get()->Millis();
+
+	if ((nMillis - m_nFailsafeMillis) < FAILSAFE_FRAME_MILLIS) {
+		return;
+	}
+
+	m_nFailsafeMillis = nMillis;
+
+	if (m_Correction.IsDither()) {
+		m_Correction.NextFrame();
 	}
 
+	// The effects are rendered on the physical outputs, the pixel map is not used
+	uint8_t aPixels[DMX_UNIVERSE_SIZE] ALIGNED;
+	const uint32_t nChunk = DMX_UNIVERSE_SIZE / m_nChannelsPerLed;
+	const uint32_t nPixels = (m_nLedGroupCount > 1) ? m_nGroups : m_nLedCount;
+
+	for (uint32_t nOutput = 0; nOutput < m_nActiveOutputs; nOutput++) {
+		for (uint32_t nFirst = 0; nFirst < nPixels; nFirst += nChunk) {
+			const uint32_t nCount = std::min(nPixels - nFirst, nChunk);
+
+			m_pPixelEffects->Render(nOutput, aPixels, nFirst, nCount, nPixels, m_nChannelsPerLed, nMillis);
+			SetLEDs(static_cast<uint8_t>(nOutput), nFirst * m_nLedGroupCount, aPixels, nCount, m_nLedGroupCount);
+		}
+	}
+
+	m_pLEDStripe->Update();
+}
+
+void WS28xxDmxMulti::Blackout(bool bBlackout) {
+	m_bBlackout = bBlackout;
+
 	if (bBlackout) {
+		while (m_pLEDStripe->IsUpdating()) {
+			// wait for completion
+		}
+
 		m_pLEDStripe->Blackout();
 	} else {
 		m_pLEDStripe->Update();
@@ -206,11 +411,11 @@ void WS28xxDmxMulti::SetLEDType(TWS28XXType tWS28xxMultiType) {
 	m_tLedType = tWS28xxMultiType;
 
 	if (tWS28xxMultiType == SK6812W) {
-		m_nBeginIndexPortId1 = 128;
-		m_nBeginIndexPortId2 = 256;
-		m_nBeginIndexPortId3 = 384;
-
+		m_nLedsPerUniverse = LEDCOUNT_RGBW_UNIVERSE;
 		m_nChannelsPerLed = 4;
+	} else {
+		m_nLedsPerUniverse = LEDCOUNT_RGB_UNIVERSE;
+		m_nChannelsPerLed = 3;
 	}
 
 	UpdateMembers();
@@ -240,13 +445,40 @@ void WS28xxDmxMulti::SetActivePorts(uint8_t nActiveOutputs) {
 	DEBUG_EXIT
 }
 
+void WS28xxDmxMulti::SetLEDGroupCount(uint16_t nLedGroupCount) {
+	DEBUG_ENTRY
+
+	m_nLedGroupCount = (nLedGroupCount == 0) ? 1 : nLedGroupCount;
+
+	UpdateMembers();
+
+	DEBUG_EXIT
+}
+
 void WS28xxDmxMulti::UpdateMembers() {
-	m_nUniverses = 1 + (m_nLedCount / (1 + m_nBeginIndexPortId1));
+	if (m_nLedGroupCount > 1) {
+		m_nLedGroupCount = std::min(m_nLedGroupCount, std::max(m_nLedCount, static_cast<uint32_t>(1)));
+		m_nGroups = std::min(m_nLedCount / m_nLedGroupCount, m_nLedsPerUniverse);
+		m_nUniverses = 1;
+	} else {
+		if (m_tSrc == WS28XXDMXMULTI_SRC_ARTNET) {
+			// An output is a page of 4 ports
+			m_nLedCount = std::min(m_nLedCount, 4 * m_nLedsPerUniverse);
+		}
+
+		m_nUniverses = (m_nLedCount == 0) ? 1 : 1 + ((m_nLedCount - 1) / m_nLedsPerUniverse);
+	}
 
 	if (m_tSrc == WS28XXDMXMULTI_SRC_E131) {
-		m_nPortIdLast = (m_nActiveOutputs * m_nUniverses)  - 1;
+		m_nPortsPerOutput = m_nUniverses;
 	} else {
-		m_nPortIdLast = ((m_nActiveOutputs - 1) * 4) + m_nUniverses - 1;
+		m_nPortsPerOutput = 4;
+	}
+
+	if (m_pPixelMap != nullptr) {
+		m_nPortIdLast = m_pPixelMap->GetPortLast();
+	} else {
+		m_nPortIdLast = ((m_nActiveOutputs - 1) * m_nPortsPerOutput) + m_nUniverses - 1;
 	}
 
 	DEBUG_PRINTF("m_tLedType=%d, m_nLedCount=%d, m_nUniverses=%d, m_nPortIndexLast=%d", static_cast<int>(m_tLedType), static_cast<int>(m_nLedCount), static_cast<int>(m_nUniverses), static_cast<int>(m_nPortIdLast));
@@ -262,8 +494,17 @@ void WS28xxDmxMulti::Print() {
 	printf(" T1H     : %.2f [0x%X]\n", WS28xx::ConvertTxH(m_pLEDStripe->GetHighCode()), m_pLEDStripe->GetHighCode());
 	printf(" Count   : %d\n", m_nLedCount);
 	printf(" Outputs : %d\n", m_nActiveOutputs);
+	if (m_nLedGroupCount > 1) {
+		printf(" Grouping: %d x %d\n", static_cast<int>(m_nGroups), static_cast<int>(m_nLedGroupCount));
+	}
 	printf(" Board   : %dx\n", m_pLEDStripe->GetBoard() == WS28XXMULTI_BOARD_4X ? 4 : 8);
 	if (m_pLEDStripe->GetBoard() == WS28XXMULTI_BOARD_4X) {
 		printf("  SI5351A : %c\n", m_bUseSI5351A ? 'Y' : 'N');
 	}
+	printf(" Dropped : %d\n", static_cast<int>(m_pLEDStripe->GetFramesDropped()));
+	m_Correction.Print();
+	m_Interpolation.Print();
+	if (m_pPixelEffects != nullptr) {
+		m_pPixelEffects->Print();
+	}
 }
@@ -47,6 +47,11 @@ void WS28xxDmxParams::Set(WS28xxDmxMulti *pWS28xxDmxMulti) {
 		pWS28xxDmxMulti->SetHighCode(m_tWS28xxParams.nHighCode);
 	}
 
+	// Before the LED count, grouping lifts the LED count limit of Art-Net
+	if (isMaskSet(WS28xxDmxParamsMask::LED_GROUPING) && m_tWS28xxParams.bLedGrouping && isMaskSet(WS28xxDmxParamsMask::LED_GROUP_COUNT)) {
+		pWS28xxDmxMulti->SetLEDGroupCount(m_tWS28xxParams.nLedGroupCount);
+	}
+
 	if (isMaskSet(WS28xxDmxParamsMask::LED_COUNT)) {
 		pWS28xxDmxMulti->SetLEDCount(m_tWS28xxParams.nLedCount);
 	}
@@ -58,4 +63,20 @@ void WS28xxDmxParams::Set(WS28xxDmxMulti *pWS28xxDmxMulti) {
 	if (isMaskSet(WS28xxDmxParamsMask::USE_SI5351A)) {
 		pWS28xxDmxMulti->SetUseSI5351A(m_tWS28xxParams.bUseSI5351A);
 	}
+
+	if (isMaskSet(WS28xxDmxParamsMask::GAMMA)) {
+		pWS28xxDmxMulti->SetGamma(GetGamma());
+	}
+
+	if (isMaskSet(WS28xxDmxParamsMask::BALANCE)) {
+		pWS28xxDmxMulti->SetWhiteBalance(m_tWS28xxParams.aBalance[0], m_tWS28xxParams.aBalance[1], m_tWS28xxParams.aBalance[2], m_tWS28xxParams.aBalance[3]);
+	}
+
+	if (isMaskSet(WS28xxDmxParamsMask::DITHER)) {
+		pWS28xxDmxMulti->SetDither(m_tWS28xxParams.bDither);
+	}
+
+	if (isMaskSet(WS28xxDmxParamsMask::INTERPOLATION_HZ)) {
+		pWS28xxDmxMulti->SetInterpolation(m_tWS28xxParams.nInterpolationHz, m_tWS28xxParams.nInterpolationMillis);
+	}
 }
@@ -44,6 +44,7 @@
 #include "ws28xx.h"
 #include "ws28xxconst.h"
 #include "ws28xxdmx.h"
+#include "pixelinterpolation.h"
 
 #include "rgbmapping.h"
 
@@ -69,6 +70,11 @@ WS28xxDmxParams::WS28xxDmxParams(WS28xxDmxParamsStore *pWS28XXStripeParamsStore)
 	m_tWS28xxParams.nRgbMapping = RGB_MAPPING_UNDEFINED;
 	m_tWS28xxParams.nLowCode = 0;
 	m_tWS28xxParams.nHighCode = 0;
+	m_tWS28xxParams.nGamma = 10;
+	memset(m_tWS28xxParams.aBalance, 0xFF, sizeof(m_tWS28xxParams.aBalance));
+	m_tWS28xxParams.bDither = false;
+	m_tWS28xxParams.nInterpolationMillis = PixelInterpolation::DELAY_MILLIS_DEFAULT;
+	m_tWS28xxParams.nInterpolationHz = 0;
 }
 
 WS28xxDmxParams::~WS28xxDmxParams() {
@@ -138,7 +144,7 @@ void WS28xxDmxParams::callbackFunction(const char *pLine) {
 	}
 
 	if (Sscan::Uint16(pLine, DevicesParamsConst::LED_COUNT, nValue16) == Sscan::OK) {
-		if (nValue16 != 0 && nValue16 <= (4 * 170)) {
+		if (nValue16 != 0 && nValue16 <= LEDCOUNT_RGB_MAX) {
 			m_tWS28xxParams.nLedCount = nValue16;
 			m_tWS28xxParams.nSetList |= WS28xxDmxParamsMask::LED_COUNT;
 		}
@@ -185,6 +191,46 @@ void WS28xxDmxParams::callbackFunction(const char *pLine) {
 		return;
 	}
 
+	if (Sscan::Float(pLine, DevicesParamsConst::LED_GAMMA, fValue) == Sscan::OK) {
+		if ((fValue >= 1.0f) && (fValue <= 3.0f)) {
+			m_tWS28xxParams.nGamma = static_cast<uint8_t>((fValue * 10.0f) + 0.5f);
+			m_tWS28xxParams.nSetList |= WS28xxDmxParamsMask::GAMMA;
+		}
+		return;
+	}
+
+	const char *pBalance[] = { DevicesParamsConst::LED_BALANCE_RED, DevicesParamsConst::LED_BALANCE_GREEN, DevicesParamsConst::LED_BALANCE_BLUE, DevicesParamsConst::LED_BALANCE_WHITE };
+
+	for (uint32_t i = 0; i < sizeof(pBalance) / sizeof(pBalance[0]); i++) {
+		if (Sscan::Uint8(pLine, pBalance[i], nValue8) == Sscan::OK) {
+			m_tWS28xxParams.aBalance[i] = nValue8;
+			m_tWS28xxParams.nSetList |= WS28xxDmxParamsMask::BALANCE;
+			return;
+		}
+	}
+
+	if (Sscan::Uint8(pLine, DevicesParamsConst::LED_DITHER, nValue8) == Sscan::OK) {
+		m_tWS28xxParams.bDither = (nValue8 != 0);
+		m_tWS28xxParams.nSetList |= WS28xxDmxParamsMask::DITHER;
+		return;
+	}
+
+	if (Sscan::Uint16(pLine, DevicesParamsConst::LED_INTERPOLATION_HZ, nValue16) == Sscan::OK) {
+		if (nValue16 <= 1000) {
+			m_tWS28xxParams.nInterpolationHz = nValue16;
+			m_tWS28xxParams.nSetList |= WS28xxDmxParamsMask::INTERPOLATION_HZ;
+		}
+		return;
+	}
+
+	if (Sscan::Uint8(pLine, DevicesParamsConst::LED_INTERPOLATION_MS, nValue8) == Sscan::OK) {
+		if (nValue8 != 0) {
+			m_tWS28xxParams.nInterpolationMillis = nValue8;
+			m_tWS28xxParams.nSetList |= WS28xxDmxParamsMask::INTERPOLATION_MS;
+		}
+		return;
+	}
+
 	if (Sscan::Uint8(pLine, DevicesParamsConst::ACTIVE_OUT, nValue8) == Sscan::OK) {
 		m_tWS28xxParams.nActiveOutputs = nValue8;
 		m_tWS28xxParams.nSetList |= WS28xxDmxParamsMask::ACTIVE_OUT;
@@ -204,7 +250,7 @@ void WS28xxDmxParams::callbackFunction(const char *pLine) {
 	}
 
 	if (Sscan::Uint16(pLine, DevicesParamsConst::LED_GROUP_COUNT, nValue16) == Sscan::OK) {
-		if (nValue16 != 0 && nValue16 <= (4 * 170)) {
+		if (nValue16 != 0 && nValue16 <= LEDCOUNT_RGB_MAX) {
 			m_tWS28xxParams.nLedGroupCount = nValue16;
 			m_tWS28xxParams.nSetList |= WS28xxDmxParamsMask::LED_GROUP_COUNT;
 		}
@@ -260,6 +306,29 @@ void WS28xxDmxParams::Dump() {
 		printf(" %s=%d\n", DevicesParamsConst::LED_COUNT, m_tWS28xxParams.nLedCount);
 	}
 
+	if (isMaskSet(WS28xxDmxParamsMask::GAMMA)) {
+		printf(" %s=%.1f\n", DevicesParamsConst::LED_GAMMA, GetGamma());
+	}
+
+	if (isMaskSet(WS28xxDmxParamsMask::BALANCE)) {
+		printf(" %s=%d\n", DevicesParamsConst::LED_BALANCE_RED, m_tWS28xxParams.aBalance[0]);
+		printf(" %s=%d\n", DevicesParamsConst::LED_BALANCE_GREEN, m_tWS28xxParams.aBalance[1]);
+		printf(" %s=%d\n", DevicesParamsConst::LED_BALANCE_BLUE, m_tWS28xxParams.aBalance[2]);
+		printf(" %s=%d\n", DevicesParamsConst::LED_BALANCE_WHITE, m_tWS28xxParams.aBalance[3]);
+	}
+
+	if (isMaskSet(WS28xxDmxParamsMask::DITHER)) {
+		printf(" %s=%d [%s]\n", DevicesParamsConst::LED_DITHER, static_cast<int>(m_tWS28xxParams.bDither), BOOL2STRING::Get(m_tWS28xxParams.bDither));
+	}
+
+	if (isMaskSet(WS28xxDmxParamsMask::INTERPOLATION_HZ)) {
+		printf(" %s=%d\n", DevicesParamsConst::LED_INTERPOLATION_HZ, m_tWS28xxParams.nInterpolationHz);
+	}
+
+	if (isMaskSet(WS28xxDmxParamsMask::INTERPOLATION_MS)) {
+		printf(" %s=%d\n", DevicesParamsConst::LED_INTERPOLATION_MS, m_tWS28xxParams.nInterpolationMillis);
+	}
+
 	if (isMaskSet(WS28xxDmxParamsMask::ACTIVE_OUT)) {
 		printf(" %s=%d\n", DevicesParamsConst::ACTIVE_OUT, m_tWS28xxParams.nActiveOutputs);
 	}
@@ -84,6 +84,18 @@ void WS28xxDmxParams::Builder(const struct TWS28xxDmxParams *ptWS28xxParams, cha
 	builder.Add(DevicesParamsConst::LED_T0H, WS28xx::ConvertTxH(m_tWS28xxParams.nLowCode), isMaskSet(WS28xxDmxParamsMask::LOW_CODE), 2);
 	builder.Add(DevicesParamsConst::LED_T1H, WS28xx::ConvertTxH(m_tWS28xxParams.nHighCode), isMaskSet(WS28xxDmxParamsMask::HIGH_CODE), 2);
 
+	builder.AddComment("Colour correction");
+	builder.Add(DevicesParamsConst::LED_GAMMA, GetGamma(), isMaskSet(WS28xxDmxParamsMask::GAMMA), 1);
+	builder.Add(DevicesParamsConst::LED_BALANCE_RED, m_tWS28xxParams.aBalance[0], isMaskSet(WS28xxDmxParamsMask::BALANCE));
+	builder.Add(DevicesParamsConst::LED_BALANCE_GREEN, m_tWS28xxParams.aBalance[1], isMaskSet(WS28xxDmxParamsMask::BALANCE));
+	builder.Add(DevicesParamsConst::LED_BALANCE_BLUE, m_tWS28xxParams.aBalance[2], isMaskSet(WS28xxDmxParamsMask::BALANCE));
+	builder.Add(DevicesParamsConst::LED_BALANCE_WHITE, m_tWS28xxParams.aBalance[3], isMaskSet(WS28xxDmxParamsMask::BALANCE));
+	builder.Add(DevicesParamsConst::LED_DITHER, m_tWS28xxParams.bDither, isMaskSet(WS28xxDmxParamsMask::DITHER));
+
+	builder.AddComment("Interpolation");
+	builder.Add(DevicesParamsConst::LED_INTERPOLATION_HZ, m_tWS28xxParams.nInterpolationHz, isMaskSet(WS28xxDmxParamsMask::INTERPOLATION_HZ));
+	builder.Add(DevicesParamsConst::LED_INTERPOLATION_MS, m_tWS28xxParams.nInterpolationMillis, isMaskSet(WS28xxDmxParamsMask::INTERPOLATION_MS));
+
 	builder.AddComment("Grouping");
 	builder.Add(DevicesParamsConst::LED_GROUPING, m_tWS28xxParams.bLedGrouping, isMaskSet(WS28xxDmxParamsMask::LED_GROUPING));
 	builder.Add(DevicesParamsConst::LED_GROUP_COUNT, m_tWS28xxParams.nLedGroupCount, isMaskSet(WS28xxDmxParamsMask::LED_GROUP_COUNT));
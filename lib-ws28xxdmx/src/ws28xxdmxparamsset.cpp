@@ -62,4 +62,20 @@ void WS28xxDmxParams::Set(WS28xxDmx *pWS28xxDmx) {
 	if (isMaskSet(WS28xxDmxParamsMask::GLOBAL_BRIGHTNESS)) {
 		pWS28xxDmx->SetGlobalBrightness(m_tWS28xxParams.nGlobalBrightness);
 	}
+
+	if (isMaskSet(WS28xxDmxParamsMask::GAMMA)) {
+		pWS28xxDmx->SetGamma(GetGamma());
+	}
+
+	if (isMaskSet(WS28xxDmxParamsMask::BALANCE)) {
+		pWS28xxDmx->SetWhiteBalance(m_tWS28xxParams.aBalance[0], m_tWS28xxParams.aBalance[1], m_tWS28xxParams.aBalance[2], m_tWS28xxParams.aBalance[3]);
+	}
+
+	if (isMaskSet(WS28xxDmxParamsMask::DITHER)) {
+		pWS28xxDmx->SetDither(m_tWS28xxParams.bDither);
+	}
+
+	if (isMaskSet(WS28xxDmxParamsMask::INTERPOLATION_HZ)) {
+		pWS28xxDmx->SetInterpolation(m_tWS28xxParams.nInterpolationHz, m_tWS28xxParams.nInterpolationMillis);
+	}
 }
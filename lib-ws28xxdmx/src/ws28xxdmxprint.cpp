@@ -44,4 +44,10 @@ void WS28xxDmx::Print() {
 			printf(" GlbBr : %d\n", m_nGlobalBrightness);
 		}
 	}
+
+	m_Correction.Print();
+	m_Interpolation.Print();
+	if (m_pPixelEffects != nullptr) {
+		m_pPixelEffects->Print();
+	}
 }
@@ -189,7 +189,10 @@ int main(int argc, char **argv) {
 		node.Run();
 		identify.Run();
 		remoteConfig.Run();
-		spiFlashStore.Flash();
+
+		if (!spiFlashStore.Flash()) {
+			nw.Wait(node.GetTimeoutMillis());
+		}
 	}
 
 	return 0;
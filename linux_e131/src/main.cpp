@@ -134,7 +134,10 @@ int main(int argc, char **argv) {
 	for (;;) {
 		bridge.Run();
 		remoteConfig.Run();
-		spiFlashStore.Flash();
+
+		if (!spiFlashStore.Flash()) {
+			nw.Wait(bridge.GetTimeoutMillis());
+		}
 	}
 
 	return 0;
@@ -112,7 +112,10 @@ int main(int argc, char **argv) {
 	for (;;) {
 		server.Run();
 		remoteConfig.Run();
-		spiFlashStore.Flash();
+
+		if (!spiFlashStore.Flash()) {
+			nw.Wait(NetworkLinux::WAIT_INFINITE);
+		}
 	}
 
 	return 0;
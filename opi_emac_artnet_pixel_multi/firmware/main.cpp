@@ -49,6 +49,8 @@
 #include "ws28xxdmxparams.h"
 #include "ws28xxdmxmulti.h"
 #include "ws28xx.h"
+#include "pixeleffects.h"
+#include "pixeleffectsparams.h"
 #include "storews28xxdmx.h"
 
 #include "spiflashinstall.h"
@@ -109,6 +111,15 @@ void notmain(void) {
 
 	ws28xxDmxMulti.Initialize();
 
+	PixelEffects pixelEffects;
+	PixelEffectsParams pixelEffectsParams;
+
+	if (pixelEffectsParams.Load()) {
+		pixelEffectsParams.Set(&pixelEffects);
+		pixelEffectsParams.Dump();
+		ws28xxDmxMulti.SetPixelEffects(&pixelEffects);
+	}
+
 	const uint8_t nActivePorts = ws28xxDmxMulti.GetActivePorts();
 
 	ArtNet4Node node(nActivePorts);
@@ -158,30 +158,14 @@ void notmain(void) {
 			pSpi = pWS28xxDmx;
 			display.Printf(7, "%s:%d", WS28xx::GetLedTypeString(pWS28xxDmx->GetLEDType()), pWS28xxDmx->GetLEDCount());
 
-			const uint16_t nLedCount = pWS28xxDmx->GetLEDCount();
-
-			if (pWS28xxDmx->GetLEDType() == SK6812W) {
-				if (nLedCount > 128) {
-					bridge.SetDirectUpdate(true);
-					bridge.SetUniverse(1, E131_OUTPUT_PORT, nUniverse + 1);
-				}
-				if (nLedCount > 256) {
-					bridge.SetUniverse(2, E131_OUTPUT_PORT, nUniverse + 2);
-				}
-				if (nLedCount > 384) {
-					bridge.SetUniverse(3, E131_OUTPUT_PORT, nUniverse + 3);
-				}
-			} else {
-				if (nLedCount > 170) {
-					bridge.SetDirectUpdate(true);
-					bridge.SetUniverse(1, E131_OUTPUT_PORT, nUniverse + 1);
-				}
-				if (nLedCount > 340) {
-					bridge.SetUniverse(2, E131_OUTPUT_PORT, nUniverse + 2);
-				}
-				if (nLedCount > 510) {
-					bridge.SetUniverse(3, E131_OUTPUT_PORT, nUniverse + 3);
-				}
+			const uint32_t nUniverses = pWS28xxDmx->GetUniverses();
+
+			if (nUniverses > 1) {
+				bridge.SetDirectUpdate(true);
+			}
+
+			for (uint32_t u = 1; (u < nUniverses) && (u < E131_MAX_PORTS); u++) {
+				bridge.SetUniverse(static_cast<uint8_t>(u), E131_OUTPUT_PORT, static_cast<uint16_t>(nUniverse + u));
 			}
 		}
 	}
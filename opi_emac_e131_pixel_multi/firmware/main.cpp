@@ -49,6 +49,10 @@
 #include "ws28xxdmxmulti.h"
 #include "ws28xx.h"
 #include "storews28xxdmx.h"
+#include "pixelmap.h"
+#include "pixelmapparams.h"
+#include "pixeleffects.h"
+#include "pixeleffectsparams.h"
 
 #include "spiflashinstall.h"
 #include "spiflashstore.h"
@@ -116,45 +120,49 @@ void notmain(void) {
 
 	ws28xxDmxMulti.Initialize();
 
+	PixelMap pixelMap;
+	PixelMapParams pixelMapParams;
+
+	if (pixelMapParams.Load()) {
+		pixelMapParams.Set(&pixelMap);
+		pixelMapParams.Dump();
+		ws28xxDmxMulti.SetPixelMap(&pixelMap);
+	}
+
+	PixelEffects pixelEffects;
+	PixelEffectsParams pixelEffectsParams;
+
+	if (pixelEffectsParams.Load()) {
+		pixelEffectsParams.Set(&pixelEffects);
+		pixelEffectsParams.Dump();
+		ws28xxDmxMulti.SetPixelEffects(&pixelEffects);
+	}
+
 	bridge.SetDirectUpdate(true);
 	bridge.SetOutput(&ws28xxDmxMulti);
 
-	const uint16_t nLedCount = ws28xxDmxMulti.GetLEDCount();
 	const uint8_t nActivePorts = ws28xxDmxMulti.GetActivePorts();
 	const uint8_t nUniverseStart = e131params.GetUniverse();
+	const uint32_t nUniverses = ws28xxDmxMulti.GetUniverses();
 
 	uint8_t nPortIndex = 0;
 
-	for (uint32_t i = 0; i < nActivePorts; i++) {
-		bridge.SetUniverse(nPortIndex, E131_OUTPUT_PORT, nPortIndex + nUniverseStart);
-
-		if (ws28xxDmxMulti.GetLEDType() == SK6812W) {
-			if (nLedCount > 128) {
-				bridge.SetUniverse(nPortIndex + 1, E131_OUTPUT_PORT, nUniverseStart + nPortIndex + 1);
-			}
-
-			if (nLedCount > 256) {
-				bridge.SetUniverse(nPortIndex + 2, E131_OUTPUT_PORT, nUniverseStart + nPortIndex + 2);
-			}
-
-			if (nLedCount > 384) {
-				bridge.SetUniverse(nPortIndex + 3, E131_OUTPUT_PORT, nUniverseStart + nPortIndex + 3);
-			}
-		} else {
-			if (nLedCount > 170) {
-				bridge.SetUniverse(nPortIndex + 1, E131_OUTPUT_PORT, nUniverseStart + nPortIndex + 1);
-			}
-
-			if (nLedCount > 340) {
-				bridge.SetUniverse(nPortIndex + 2, E131_OUTPUT_PORT, nUniverseStart + nPortIndex + 2);
-			}
-
-			if (nLedCount > 510) {
-				bridge.SetUniverse(nPortIndex + 3, E131_OUTPUT_PORT, nUniverseStart + nPortIndex + 3);
+	if (pixelMapParams.GetRuns() != 0) {
+		for (uint32_t i = 0; (i <= pixelMap.GetPortLast()) && (nPortIndex < E131_MAX_PORTS); i++) {
+			bridge.SetUniverse(nPortIndex, E131_OUTPUT_PORT, nUniverseStart + nPortIndex);
+			nPortIndex++;
+		}
+	} else {
+		for (uint32_t i = 0; i < nActivePorts; i++) {
+			for (uint32_t u = 0; u < nUniverses; u++) {
+				if (nPortIndex >= E131_MAX_PORTS) {
+					break;
+				}
+
+				bridge.SetUniverse(nPortIndex, E131_OUTPUT_PORT, nUniverseStart + nPortIndex);
+				nPortIndex++;
 			}
 		}
-
-		nPortIndex += ws28xxDmxMulti.GetUniverses();
 	}
 
 	bridge.Print();